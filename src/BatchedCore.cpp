@@ -0,0 +1,256 @@
+// BatchedCore.cpp
+
+#include "BatchedCore.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+constexpr double vesselCode = static_cast<double>(MaterialType::Vessel);
+constexpr double fuelCode = static_cast<double>(MaterialType::Fuel);
+constexpr double controlRodCode = static_cast<double>(MaterialType::ControlRod);
+
+} // namespace
+
+BatchedCore::BatchedCore(int xSize, int ySize, int zSize, int laneCount)
+    : xSize(xSize), ySize(ySize), zSize(zSize), laneCount(laneCount),
+      cellCount(static_cast<std::size_t>(xSize) * ySize * zSize),
+      state(fieldSlotCount * cellCount * laneCount, 0.0),
+      newFlux(numEnergyGroups * cellCount * laneCount, 0.0),
+      laneCores(laneCount, nullptr),
+      laneRevisions(laneCount, 0),
+      temperatureCoefficients(laneCount, 0.0),
+      voidCoefficients(laneCount, 0.0) {}
+
+bool BatchedCore::matches(const Core& core) const {
+    return core.getXSize() == xSize && core.getYSize() == ySize && core.getZSize() == zSize;
+}
+
+bool BatchedCore::load(int lane, const Core& core) {
+    if (lane < 0 || lane >= laneCount || !matches(core)) {
+        std::cerr << "BatchedCore: core does not fit lane " << lane << std::endl;
+        return false;
+    }
+
+    const auto& elements = core.getElements();
+    temperatureCoefficients[lane] = core.getTemperatureCoefficient();
+    voidCoefficients[lane] = core.getVoidCoefficient();
+
+    // Materials and cross-sections only change on rod moves, scram and restores
+    if (laneCores[lane] != &core || laneRevisions[lane] != core.getMaterialRevision()) {
+        double element[CoreElement::stateSize];
+        for (std::size_t cell = 0; cell < cellCount; ++cell) {
+            elements[cell].writeState(element);
+            for (int f = 0; f < CoreElement::stateSize; ++f) {
+                if (!CoreElement::isAccumulatorField(f)) {
+                    field(f)[cell * laneCount + lane] = static_cast<FieldReal>(element[f]);
+                }
+            }
+        }
+        laneCores[lane] = &core;
+        laneRevisions[lane] = core.getMaterialRevision();
+        activeCellsValid = false;
+        return true;
+    }
+
+    // This lane's materials are unchanged, so its non-vessel cells are all in the list
+    updateActiveCells();
+    for (std::size_t cell : activeCells) {
+        const CoreElement& element = elements[cell];
+        const std::size_t i = cell * laneCount + lane;
+        field(CoreElement::StateTemperature)[i] = element.getTemperature();
+        field(CoreElement::StateReactivity)[i] = element.getReactivity();
+        field(CoreElement::StateNeutronPopulation)[i] = element.getNeutronPopulation();
+        field(CoreElement::StateCoolantVoid)[i] = element.getCoolantVoid();
+        for (int g = 0; g < numEnergyGroups; ++g) {
+            field(CoreElement::stateFluxField(g))[i] = element.getNeutronFlux(g);
+        }
+    }
+    return true;
+}
+
+bool BatchedCore::store(int lane, Core& core) const {
+    if (lane < 0 || lane >= laneCount || laneCores[lane] != &core) {
+        std::cerr << "BatchedCore: lane " << lane << " was not loaded from this core" << std::endl;
+        return false;
+    }
+
+    // Only the fields the kernels write, of the cells they visit
+    auto& elements = core.getElements();
+    for (std::size_t cell : activeCells) {
+        CoreElement& element = elements[cell];
+        const std::size_t i = cell * laneCount + lane;
+        element.setTemperature(field(CoreElement::StateTemperature)[i]);
+        element.setReactivity(field(CoreElement::StateReactivity)[i]);
+        element.setNeutronPopulation(field(CoreElement::StateNeutronPopulation)[i]);
+        for (int g = 0; g < numEnergyGroups; ++g) {
+            element.setNeutronFlux(g, field(CoreElement::stateFluxField(g))[i]);
+        }
+    }
+    return true;
+}
+
+void BatchedCore::updateActiveCells() {
+    if (activeCellsValid) {
+        return;
+    }
+    activeCellsValid = true;
+
+    const FieldReal* material = field(CoreElement::StateMaterial);
+    activeCells.clear();
+    for (std::size_t cell = 0; cell < cellCount; ++cell) {
+        for (int k = 0; k < laneCount; ++k) {
+            if (material[cell * laneCount + k] != vesselCode) {
+                activeCells.push_back(cell);
+                break;
+            }
+        }
+    }
+}
+
+void BatchedCore::advance(double deltaTime, int fluxSubsteps) {
+    for (int substep = 0; substep < fluxSubsteps; ++substep) {
+        calculateMultiGroupNeutronFlux(deltaTime / fluxSubsteps);
+    }
+    calculateCoreThermals(deltaTime);
+}
+
+void BatchedCore::calculateMultiGroupNeutronFlux(double deltaTime) {
+    const int lanes = laneCount;
+    const std::size_t xStride = static_cast<std::size_t>(ySize) * zSize * lanes;
+    const std::size_t yStride = static_cast<std::size_t>(zSize) * lanes;
+    const std::size_t zStride = lanes;
+
+    // Spatial steps
+    const double dx = 1.0;
+    const double dy = 1.0;
+    const double dz = 1.0;
+
+    const FieldReal* material = field(CoreElement::StateMaterial);
+    const FieldReal* flux[numEnergyGroups];
+    const FieldReal* sigmaF[numEnergyGroups];
+    for (int g = 0; g < numEnergyGroups; ++g) {
+        flux[g] = field(CoreElement::stateFluxField(g));
+        sigmaF[g] = field(CoreElement::stateSigmaFField(g));
+    }
+
+    for (int g = 0; g < numEnergyGroups; ++g) {
+        const double D_g = 1.0; // Diffusion coefficient for group g
+        const FieldReal* phi = flux[g];
+        const FieldReal* sigmaA = field(CoreElement::stateSigmaAField(g));
+        const FieldReal* chi = field(CoreElement::stateChiField(g));
+        const FieldReal* sigmaS[numEnergyGroups];
+        for (int gp = 0; gp < numEnergyGroups; ++gp) {
+            sigmaS[gp] = field(CoreElement::stateSigmaSField(gp, g));
+        }
+        FieldReal* out = newFlux.data() + g * cellCount * lanes;
+
+        for (int x = 0; x < xSize; ++x) {
+            for (int y = 0; y < ySize; ++y) {
+                for (int z = 0; z < zSize; ++z) {
+                    const std::size_t base = index(x, y, z) * lanes;
+
+                    // Core leaves the outer shell at zero flux
+                    if (x == 0 || x == xSize - 1 || y == 0 || y == ySize - 1 || z == 0 || z == zSize - 1) {
+                        for (int k = 0; k < lanes; ++k) {
+                            out[base + k] = 0.0;
+                        }
+                        continue;
+                    }
+
+#pragma omp simd
+                    for (int k = 0; k < lanes; ++k) {
+                        const std::size_t i = base + k;
+                        double phi_center = phi[i];
+
+                        double laplacian = (phi[i + xStride] - 2 * phi_center + phi[i - xStride]) / (dx * dx)
+                                         + (phi[i + yStride] - 2 * phi_center + phi[i - yStride]) / (dy * dy)
+                                         + (phi[i + zStride] - 2 * phi_center + phi[i - zStride]) / (dz * dz);
+
+                        double absorption = -sigmaA[i] * phi_center;
+
+                        double scattering = 0.0;
+                        for (int gp = 0; gp < numEnergyGroups; ++gp) {
+                            if (gp != g) {
+                                scattering += static_cast<double>(sigmaS[gp][i]) * flux[gp][i];
+                            }
+                        }
+
+                        double fission_source = 0.0;
+                        for (int gp = 0; gp < numEnergyGroups; ++gp) {
+                            fission_source += static_cast<double>(chi[i]) * sigmaF[gp][i] * flux[gp][i];
+                        }
+
+                        double rhs = D_g * laplacian + absorption + scattering + fission_source;
+                        out[i] = material[i] == fuelCode ? phi_center + deltaTime * rhs : 0.0;
+                    }
+                }
+            }
+        }
+    }
+
+    for (int g = 0; g < numEnergyGroups; ++g) {
+        std::copy(newFlux.begin() + g * cellCount * lanes, newFlux.begin() + (g + 1) * cellCount * lanes,
+                  field(CoreElement::stateFluxField(g)));
+    }
+}
+
+void BatchedCore::calculateCoreThermals(double deltaTime) {
+    const int lanes = laneCount;
+    const std::ptrdiff_t offsets[6] = {
+        -static_cast<std::ptrdiff_t>(ySize) * zSize * lanes, static_cast<std::ptrdiff_t>(ySize) * zSize * lanes,
+        -static_cast<std::ptrdiff_t>(zSize) * lanes, static_cast<std::ptrdiff_t>(zSize) * lanes,
+        -static_cast<std::ptrdiff_t>(lanes), static_cast<std::ptrdiff_t>(lanes)
+    };
+
+    const double* temperatureCoefficient = temperatureCoefficients.data();
+    const double* voidCoefficient = voidCoefficients.data();
+    const double specificHeatCapacity = 300.0; // Fuel
+    const double mass = 1.0;
+
+    const FieldReal* material = field(CoreElement::StateMaterial);
+    FieldReal* temperature = field(CoreElement::StateTemperature);
+    FieldReal* reactivity = field(CoreElement::StateReactivity);
+    FieldReal* population = field(CoreElement::StateNeutronPopulation);
+    const FieldReal* coolantVoid = field(CoreElement::StateCoolantVoid);
+
+    // Reactivity depends only on neighbor materials and the cell's own temperature and void, so
+    // both of Core's passes can be fused per cell
+    updateActiveCells();
+    for (std::size_t cell : activeCells) {
+        const int x = static_cast<int>(cell / (static_cast<std::size_t>(ySize) * zSize));
+        const int y = static_cast<int>(cell / zSize % ySize);
+        const int z = static_cast<int>(cell % zSize);
+        const std::size_t base = cell * lanes;
+        const bool inside[6] = { x > 0, x < xSize - 1, y > 0, y < ySize - 1, z > 0, z < zSize - 1 };
+
+#pragma omp simd
+        for (int k = 0; k < lanes; ++k) {
+            const std::size_t i = base + k;
+            if (material[i] == vesselCode) {
+                continue;
+            }
+
+            // Neighbors in getNeighbors order
+            double reactivityEffect = 0.0;
+            for (int n = 0; n < 6; ++n) {
+                if (inside[n]) {
+                    double neighbor = material[i + offsets[n]];
+                    reactivityEffect += neighbor == fuelCode ? 0.01 : (neighbor == controlRodCode ? -0.02 : 0.0);
+                }
+            }
+            // Rounded to storage precision first, as CoreElement stores it before Core reads it back
+            const FieldReal r = static_cast<FieldReal>(reactivityEffect + temperatureCoefficient[k] * (temperature[i] - 300.0)
+                                                       + voidCoefficient[k] * coolantVoid[i]);
+            reactivity[i] = r;
+
+            if (material[i] == fuelCode) {
+                double newNeutronPopulation = population[i] * Core::populationGrowth(static_cast<double>(r), deltaTime);
+                population[i] = newNeutronPopulation;
+
+                double heatGenerated = newNeutronPopulation * 1000.0;
+                temperature[i] += (heatGenerated * deltaTime) / (mass * specificHeatCapacity);
+            }
+        }
+    }
+}
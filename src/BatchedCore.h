@@ -0,0 +1,76 @@
+// BatchedCore.h
+
+#ifndef BATCHEDCORE_H
+#define BATCHEDCORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Core.h"
+
+// Steps the core physics of several independent, identically sized reactor instances together.
+//
+// Every CoreElement state field is stored structure-of-arrays with the instances interleaved:
+// the same cell of each instance ("lane") sits in adjacent doubles, so the flux and thermal
+// kernels vectorize across instances instead of along z. On small cores (10x10x10 has
+// only 8 interior cells per z column) this fills SIMD registers that a single Core cannot.
+//
+// The kernels repeat Core's arithmetic in the same order and precision (double arithmetic,
+// rounded to FieldReal where CoreElement stores it), so a lane advanced here ends up
+// bit-identical to the same Core advanced on its own in either precision build. Burnup is
+// left to the Cores (Core::advanceBurnup): it runs on a slow clock and only reads the flux.
+class BatchedCore {
+public:
+    BatchedCore(int xSize, int ySize, int zSize, int laneCount);
+
+    // Copy one instance's element state into / out of its lane. Materials and cross-sections
+    // are reloaded only when the Core's material revision changes; store writes back only the
+    // fields the kernels evolve. The burnup fields stay in the Core.
+    bool load(int lane, const Core& core);
+    bool store(int lane, Core& core) const;
+
+    // Same phases as Core, applied to every lane
+    void calculateMultiGroupNeutronFlux(double deltaTime);
+    void calculateCoreThermals(double deltaTime);
+
+    // Flux in fluxSubsteps substeps, then thermals (the order MainSimulation::iterate uses)
+    void advance(double deltaTime, int fluxSubsteps = 1);
+
+    [[nodiscard]] int getLaneCount() const { return laneCount; }
+    [[nodiscard]] double getTemperature(int lane, int x, int y, int z) const {
+        return field(CoreElement::StateTemperature)[index(x, y, z) * laneCount + lane];
+    }
+
+private:
+    int xSize, ySize, zSize;
+    int laneCount;
+    std::size_t cellCount;
+    std::vector<FieldReal> state;       // [field][cell][lane], state fields except burnup
+    std::vector<FieldReal> newFlux;     // [group][cell][lane]
+    std::vector<const Core*> laneCores;
+    std::vector<std::uint64_t> laneRevisions;
+    std::vector<double> temperatureCoefficients; // Per lane, so sweeps can batch different plants
+    std::vector<double> voidCoefficients;
+
+    // Cells that are not vessel in some lane, ascending. Vessel cells take no part in the
+    // kernels, so load, store and the thermals skip them; rebuilt after a material reload.
+    std::vector<std::size_t> activeCells;
+    bool activeCellsValid = false;
+    void updateActiveCells();
+
+    [[nodiscard]] std::size_t index(int x, int y, int z) const {
+        return static_cast<std::size_t>(x) * ySize * zSize + static_cast<std::size_t>(y) * zSize + z;
+    }
+    [[nodiscard]] bool matches(const Core& core) const;
+
+    // The accumulator (burnup) fields are contiguous in the CoreElement layout and not stored
+    static constexpr int accumulatorCount = CoreElement::StateXe135Concentration - CoreElement::StateSigmaA0 + 1;
+    static constexpr int fieldSlotCount = CoreElement::stateSize - accumulatorCount;
+    static constexpr int fieldSlot(int f) { return f < CoreElement::StateSigmaA0 ? f : f - accumulatorCount; }
+
+    FieldReal* field(int f) { return state.data() + fieldSlot(f) * cellCount * laneCount; }
+    [[nodiscard]] const FieldReal* field(int f) const { return state.data() + fieldSlot(f) * cellCount * laneCount; }
+};
+
+#endif // BATCHEDCORE_H
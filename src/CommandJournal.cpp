@@ -0,0 +1,142 @@
+// CommandJournal.cpp
+
+#include "CommandJournal.h"
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include "Core.h"
+#include "CoolantSystem.h"
+
+namespace {
+
+constexpr int journalVersion = 1;
+
+} // namespace
+
+bool CommandJournal::open(const std::string& path, double step, const Core& core, const CoolantSystem& coolantSystem,
+                          const JournalModel& modelOptions, std::uint64_t stateHash) {
+    out.open(path, std::ios::trunc);
+    if (!out) {
+        std::cerr << "Failed to open command journal " << path << std::endl;
+        return false;
+    }
+
+    timeStep = step;
+    xSize = core.getXSize();
+    ySize = core.getYSize();
+    zSize = core.getZSize();
+    coolantChunks = coolantSystem.getChunksPerLoop();
+    coolantLoops = coolantSystem.getLoopCount();
+    model = modelOptions;
+    initialStateHash = stateHash;
+
+    out << "rxtrainer-journal " << journalVersion << "\n"
+        << "timestep " << std::setprecision(17) << timeStep << "\n"
+        << "core " << xSize << " " << ySize << " " << zSize << "\n"
+        << "coolant " << coolantChunks << " " << coolantLoops << "\n"
+        << "model " << model.pointKinetics << " " << model.fluxSubsteps << " " << model.burnupInterval << " "
+        << model.adaptiveStep << " " << model.stepTolerance << " " << model.conductionInterval << "\n"
+        << "initial-state " << std::hex << initialStateHash << std::dec << std::endl;
+    return true;
+}
+
+void CommandJournal::record(std::uint64_t step, const std::string& command) {
+    entries.push_back({step, command});
+    if (out.is_open()) {
+        out << "step " << step << " " << command << std::endl;
+    }
+}
+
+void CommandJournal::finish(std::uint64_t step, std::uint64_t stateHash) {
+    hasEnd = true;
+    endStep = step;
+    finalStateHash = stateHash;
+    if (out.is_open()) {
+        out << "end " << step << " " << std::hex << stateHash << std::dec << std::endl;
+        out.close();
+    }
+}
+
+bool CommandJournal::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Failed to open command journal " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int version = 0;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string key;
+        fields >> key;
+
+        if (key == "rxtrainer-journal") {
+            fields >> version;
+        } else if (key == "timestep") {
+            fields >> timeStep;
+        } else if (key == "core") {
+            fields >> xSize >> ySize >> zSize;
+        } else if (key == "coolant") {
+            // Journals from single-loop builds have no loop count
+            fields >> coolantChunks;
+            if (!(fields >> coolantLoops)) {
+                coolantLoops = 1;
+                fields.clear();
+            }
+        } else if (key == "model") {
+            fields >> model.pointKinetics >> model.fluxSubsteps >> model.burnupInterval >> model.adaptiveStep
+                >> model.stepTolerance;
+            // Journals from before the conduction interval conducted every step
+            if (!fields.fail() && !(fields >> model.conductionInterval)) {
+                model.conductionInterval = 0.0;
+                fields.clear();
+            }
+        } else if (key == "initial-state") {
+            fields >> std::hex >> initialStateHash;
+        } else if (key == "step") {
+            JournalEntry entry;
+            fields >> entry.step;
+            fields >> std::ws;
+            std::getline(fields, entry.command);
+            entries.push_back(entry);
+        } else if (key == "end") {
+            fields >> endStep >> std::hex >> finalStateHash;
+            hasEnd = true;
+        } else if (!key.empty() && key[0] != '#') {
+            std::cerr << "Unrecognized journal line: " << line << std::endl;
+            return false;
+        }
+
+        if (fields.fail()) {
+            std::cerr << "Malformed journal line: " << line << std::endl;
+            return false;
+        }
+    }
+
+    if (version != journalVersion || timeStep <= 0.0 || xSize <= 0 || coolantChunks <= 0 || coolantLoops <= 0
+        || model.fluxSubsteps <= 0 || model.burnupInterval < 0.0 || model.stepTolerance <= 0.0 || model.conductionInterval < 0.0) {
+        std::cerr << path << " is not a valid command journal." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::uint64_t computeStateHash(const Core& core, const CoolantSystem& coolantSystem, bool scramInitiated) {
+    std::vector<double> state;
+    state.push_back(scramInitiated ? 1.0 : 0.0);
+    core.captureState(state);
+    coolantSystem.captureState(state);
+
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (double value : state) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (bits >> (8 * i)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash;
+}
@@ -0,0 +1,75 @@
+// CommandJournal.h
+
+#ifndef COMMANDJOURNAL_H
+#define COMMANDJOURNAL_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class Core;
+class CoolantSystem;
+
+struct JournalEntry {
+    std::uint64_t step;   // Number of completed steps when the command took effect
+    std::string command;  // Canonical command text, as accepted by MainSimulation
+};
+
+// Model options that change the trajectory, so a replay has to run with the recorded ones
+struct JournalModel {
+    bool pointKinetics = false;
+    int fluxSubsteps = 1;
+    double burnupInterval = 10.0;
+    bool adaptiveStep = false;
+    double stepTolerance = 1e-3;
+    double conductionInterval = 0.0; // Journals without one conducted every step
+};
+
+// Plain-text record of an operator session, sufficient to re-run it bit-identically:
+//
+//   rxtrainer-journal 1
+//   timestep <seconds>
+//   core <x> <y> <z>
+//   coolant <chunks per loop> <loops>
+//   model <point kinetics 0/1> <flux substeps> <burnup interval> <adaptive 0/1> <step tolerance>
+//         <conduction interval>
+//   initial-state <hash>
+//   step <n> <command>
+//   ...
+//   end <n> <hash>
+//
+// Lines are flushed as they are written so an interrupted session still replays
+// up to its last command. Journals without a model line were recorded with the defaults.
+class CommandJournal {
+public:
+    double timeStep = 0.0;
+    int xSize = 0, ySize = 0, zSize = 0;
+    int coolantChunks = 0;
+    int coolantLoops = 1;
+    JournalModel model;
+    std::uint64_t initialStateHash = 0;
+    std::vector<JournalEntry> entries;
+
+    bool hasEnd = false;
+    std::uint64_t endStep = 0;
+    std::uint64_t finalStateHash = 0;
+
+    // Writing
+    bool open(const std::string& path, double timeStep, const Core& core, const CoolantSystem& coolantSystem,
+              const JournalModel& model, std::uint64_t initialStateHash);
+    void record(std::uint64_t step, const std::string& command);
+    void finish(std::uint64_t step, std::uint64_t stateHash);
+    [[nodiscard]] bool isOpen() const { return out.is_open(); }
+
+    // Reading
+    bool load(const std::string& path);
+
+private:
+    std::ofstream out;
+};
+
+// FNV-1a over the bit patterns of the full plant state
+std::uint64_t computeStateHash(const Core& core, const CoolantSystem& coolantSystem, bool scramInitiated);
+
+#endif // COMMANDJOURNAL_H
@@ -0,0 +1,198 @@
+// CoolantChannels.cpp
+
+#include "CoolantChannels.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "Core.h"
+#include "DeterministicReduction.h"
+#include "WaterProperties.h"
+
+namespace {
+
+constexpr double pressure = WaterProperties::nominalPressure;
+constexpr double gravity = 9.81; // m/s^2
+
+} // namespace
+
+void CoolantChannels::updateChannels(Core& core) {
+    // Fuel cells are sorted by index and z is the fastest index, so each (x, y) column is a
+    // contiguous run of the list with z ascending
+    const auto& fuelCells = core.getFuelCells();
+    const int zSize = core.getZSize();
+
+    channelStart.clear();
+    int column = -1;
+    for (std::size_t i = 0; i < fuelCells.size(); ++i) {
+        if (fuelCells[i] / zSize != column) {
+            column = fuelCells[i] / zSize;
+            channelStart.push_back(i);
+        }
+    }
+    channelStart.push_back(fuelCells.size());
+
+    const WaterProperties& properties = WaterProperties::get();
+    coolantEnthalpy.resize(fuelCells.size(), properties.lookup(WaterProperties::Property::Enthalpy, pressure, 300.0));
+    coolantTemperature.resize(fuelCells.size(), 300.0);
+    coolantVoid.resize(fuelCells.size(), 0.0);
+    transfer.resize(fuelCells.size());
+    effectiveness.resize(fuelCells.size());
+    viscosity.resize(fuelCells.size());
+    conductivity.resize(fuelCells.size());
+    channelOutlet.resize(getChannelCount());
+    channelPeakFlux.resize(getChannelCount());
+    channelRevision = core.getMaterialRevision();
+}
+
+void CoolantChannels::updateEffectiveness(double massFlux, double capacityRate) {
+    // Properties of the coolant beside every cell in three batched lookups, then one pass
+    const WaterProperties& properties = WaterProperties::get();
+    const WaterProperties::Saturation saturation = properties.saturation(pressure);
+    properties.lookup(WaterProperties::Property::HeatCapacity, pressure, coolantTemperature, effectiveness);
+    properties.lookup(WaterProperties::Property::Viscosity, pressure, coolantTemperature, viscosity);
+    properties.lookup(WaterProperties::Property::ThermalConductivity, pressure, coolantTemperature, conductivity);
+
+    const std::size_t cellCount = effectiveness.size();
+    for (std::size_t i = 0; i < cellCount; ++i) {
+        const double enthalpy = coolantEnthalpy[i];
+        double coefficient;
+        if (enthalpy > saturation.liquidEnthalpy && enthalpy < saturation.vapourEnthalpy) {
+            // Only the liquid carries the convection in a boiling cell
+            coefficient = heatTransferCoefficient(massFlux * (1.0 - saturation.quality(enthalpy)), saturation.liquidHeatCapacity,
+                                                  saturation.liquidViscosity, saturation.liquidConductivity);
+        } else {
+            coefficient = heatTransferCoefficient(massFlux, effectiveness[i], viscosity[i], conductivity[i]);
+        }
+        effectiveness[i] = 1.0 - std::exp(-coefficient * heatedArea / capacityRate);
+    }
+}
+
+double CoolantChannels::heatTransferCoefficient(double massFlux, double heatCapacity, double viscosity,
+                                                double conductivity) {
+    const double reynolds = massFlux * hydraulicDiameter / viscosity;
+    const double prandtl = viscosity * heatCapacity / conductivity;
+    return 0.023 * std::pow(reynolds, 0.8) * std::pow(prandtl, 0.4) * conductivity / hydraulicDiameter; // W/(m^2 K)
+}
+
+double CoolantChannels::exchangeHeat(Core& core, double inletEnthalpy, double massFlowRate, double deltaTime) {
+    const auto& fuelCells = core.getFuelCells();
+    if (channelRevision != core.getMaterialRevision() || channelStart.empty()
+        || channelStart.back() != fuelCells.size()) {
+        updateChannels(core);
+    }
+
+    auto& elements = core.getElements();
+    const std::size_t channelCount = getChannelCount();
+    if (std::isnan(inletEnthalpy)) {
+        // Drained: the core is uncovered
+        for (std::size_t i = 0; i < fuelCells.size(); ++i) {
+            coolantVoid[i] = 1.0;
+            elements[fuelCells[i]].setCoolantVoid(1.0);
+        }
+        meanVoid = fuelCells.empty() ? 0.0 : 1.0;
+        maxOutletTemperature = std::numeric_limits<double>::quiet_NaN();
+        peakHeatFlux = 0.0;
+        return 0.0;
+    }
+
+    const WaterProperties& properties = WaterProperties::get();
+    const double inletTemperature = properties.temperature(pressure, inletEnthalpy);
+    if (channelCount == 0 || massFlowRate <= 0.0) {
+        // No forced flow: the fuel keeps its heat
+        maxOutletTemperature = inletTemperature;
+        peakHeatFlux = 0.0;
+        return 0.0;
+    }
+
+    const WaterProperties::Saturation saturation = properties.saturation(pressure);
+    const double heatCapacity = properties.lookup(WaterProperties::Property::HeatCapacity, pressure, inletTemperature);
+    const double channelFlow = massFlowRate / static_cast<double>(channelCount); // kg/s
+    const double capacityRate = channelFlow * heatCapacity; // m*c, W/K
+    const double massFlux = channelFlow / flowArea;         // kg/(m^2 s)
+
+    // Coolant temperature along a channel: the inlet heat capacity carries it up to Tsat, it
+    // stays there while boiling, and dry steam reads the tables
+    auto temperatureAt = [&](double enthalpy) {
+        return enthalpy <= saturation.vapourEnthalpy
+                   ? std::min(saturation.temperature, inletTemperature + (enthalpy - inletEnthalpy) / heatCapacity)
+                   : properties.temperature(pressure, enthalpy);
+    };
+
+    updateEffectiveness(massFlux, capacityRate);
+
+    // Channels are independent; the heat is summed in a fixed order
+    double heatRemoved = deterministicSum(channelCount, [&](std::size_t channel) {
+        const std::size_t begin = channelStart[channel];
+        const std::size_t end = channelStart[channel + 1];
+
+        // March the coolant up the channel; transfer holds the heat flux into the coolant
+        double enthalpy = inletEnthalpy;
+        double coolant = inletTemperature;
+        for (std::size_t i = begin; i < end; ++i) {
+            const CoreElement& element = elements[fuelCells[i]];
+            double capacity = element.getHeatCapacity();
+            double fraction = effectiveness[i] * capacity / (capacity + effectiveness[i] * capacityRate * deltaTime);
+            double heatFlux = capacityRate * fraction * (element.getTemperature() - coolant); // W
+            double rise = heatFlux / channelFlow; // J/kg
+            coolantEnthalpy[i] = enthalpy + 0.5 * rise;
+            transfer[i] = heatFlux;
+            enthalpy += rise;
+            coolant = temperatureAt(enthalpy);
+        }
+        channelOutlet[channel] = coolant;
+
+        // Take the heat out of the fuel
+        double channelHeat = 0.0;
+        double peakFlux = 0.0;
+        for (std::size_t i = begin; i < end; ++i) {
+            elements[fuelCells[i]].updateTemperature(-transfer[i], deltaTime);
+            channelHeat += transfer[i] * deltaTime;
+            peakFlux = std::max(peakFlux, transfer[i]);
+        }
+        channelPeakFlux[channel] = peakFlux;
+        return channelHeat;
+    });
+
+    maxOutletTemperature = *std::max_element(channelOutlet.begin(), channelOutlet.end());
+    peakHeatFlux = *std::max_element(channelPeakFlux.begin(), channelPeakFlux.end());
+
+    updateVoid(core, channelFlow);
+    return heatRemoved;
+}
+
+void CoolantChannels::updateVoid(Core& core, double channelFlow) {
+    const WaterProperties& properties = WaterProperties::get();
+    const WaterProperties::Saturation saturation = properties.saturation(pressure);
+
+    // Every channel runs at the same pressure and flow, so the drift-flux terms are scalars for
+    // the frame: Zuber-Findlay void fraction with C0 = 1.13 and the churn-flow drift velocity
+    // Vgj = 1.41 (sigma g (rho_f - rho_g) / rho_f^2)^(1/4)
+    const double liquidDensity = saturation.liquidDensity;
+    const double vapourDensity = saturation.vapourDensity;
+    const double densityRatio = vapourDensity / liquidDensity;
+    const double driftVelocity = 1.41 * std::pow(saturation.surfaceTension * gravity * (liquidDensity - vapourDensity)
+                                                     / (liquidDensity * liquidDensity), 0.25);
+    const double driftTerm = vapourDensity * driftVelocity / (channelFlow / flowArea);
+
+    // One batched pass over all cells of all channels
+    properties.temperatures(pressure, coolantEnthalpy, coolantTemperature);
+    const std::size_t cellCount = coolantEnthalpy.size();
+    double voidSum = 0.0;
+    for (std::size_t i = 0; i < cellCount; ++i) {
+        const double quality = saturation.quality(coolantEnthalpy[i]);
+        const double liquid = 1.0 - quality;
+
+        // The slip terms fade out with the liquid, so dry steam reads as full void
+        const double distribution = 1.0 + (distributionParameter - 1.0) * liquid;
+        coolantVoid[i] = quality / (distribution * (quality + liquid * densityRatio) + liquid * driftTerm);
+        voidSum += coolantVoid[i];
+    }
+    meanVoid = cellCount > 0 ? voidSum / static_cast<double>(cellCount) : 0.0;
+
+    // Feed the void back to the core
+    const auto& fuelCells = core.getFuelCells();
+    auto& elements = core.getElements();
+    for (std::size_t i = 0; i < cellCount; ++i) {
+        elements[fuelCells[i]].setCoolantVoid(coolantVoid[i]);
+    }
+}
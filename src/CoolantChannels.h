@@ -0,0 +1,81 @@
+// CoolantChannels.h
+
+#ifndef COOLANTCHANNELS_H
+#define COOLANTCHANNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Core;
+
+// Axial coolant channels through the core, one per (x, y) column that holds fuel. Coolant
+// enters every channel at the inlet plenum enthalpy with an even share of the loop flow
+// and rises through the column in z. Each fuel cell it passes gives up heat in proportion to
+// the local fuel-to-coolant temperature difference, so hot spots see hot coolant.
+//
+// A cell with conductance U = h * A passes heat to a stream of capacity rate m*c with
+// effectiveness e = 1 - exp(-U / (m*c)). The fuel side is implicit over the step, which keeps
+// the exchange stable for any step size and makes the heat a cell passes affine in the
+// coolant temperature beside it:
+//
+//   q = m*c * g * (T_fuel - T_coolant),   g = e * C / (C + e * m*c * dt)
+//
+// with C the cell heat capacity. h is the Dittus-Boelter forced convection coefficient of
+// the coolant beside the cell, Nu = 0.023 Re^0.8 Pr^0.4 over the channel's hydraulic
+// diameter, so it follows the local temperature up the channel. Boiling cells use the
+// liquid part of the flow at saturation (the convective term of the Chen correlation,
+// without its two-phase enhancement), so heat transfer falls away as the channel dries out.
+// The effectiveness of every cell comes from the coolant of the last step in batched passes
+// over all cells, which leaves the march up each channel a plain scan.
+//
+// The coolant state is its specific enthalpy at primary pressure. Once it reaches the
+// saturated liquid enthalpy it boils at Tsat; the quality and the void fraction (Zuber-Findlay
+// drift flux) of every cell are then found in one batched pass over all the channels.
+class CoolantChannels {
+public:
+    // Cools the fuel for one step, sets each fuel cell's coolant void, and returns the heat
+    // carried off by the coolant (J). massFlowRate is the whole core's. A NaN inlet enthalpy
+    // means the loops have drained.
+    double exchangeHeat(Core& core, double inletEnthalpy, double massFlowRate, double deltaTime);
+
+    [[nodiscard]] std::size_t getChannelCount() const { return channelStart.empty() ? 0 : channelStart.size() - 1; }
+
+    // Coolant beside core.getFuelCells()[i] (at the middle of the cell)
+    [[nodiscard]] double getCoolantTemperature(std::size_t fuelIndex) const { return coolantTemperature[fuelIndex]; }
+    [[nodiscard]] double getCoolantEnthalpy(std::size_t fuelIndex) const { return coolantEnthalpy[fuelIndex]; }
+    [[nodiscard]] double getCoolantVoid(std::size_t fuelIndex) const { return coolantVoid[fuelIndex]; }
+
+    [[nodiscard]] double getMaxOutletTemperature() const { return maxOutletTemperature; }
+    [[nodiscard]] double getPeakHeatFlux() const { return peakHeatFlux; } // W per cell face
+    [[nodiscard]] double getMeanVoid() const { return meanVoid; }         // Over the fuel cells
+
+    static constexpr double flowArea = 1.5e-4;             // m^2 per channel
+    static constexpr double hydraulicDiameter = 0.0118;    // m, of a rod bundle subchannel
+    static constexpr double heatedArea = 0.054;            // m^2 of rod surface per cell (40 rods of 9.5 mm)
+    static constexpr double distributionParameter = 1.13;  // Drift-flux C0
+
+private:
+    std::vector<std::size_t> channelStart; // Into the fuel cell list, plus an end marker
+    std::uint64_t channelRevision = ~std::uint64_t{0};
+    std::vector<double> coolantEnthalpy;    // Per fuel cell
+    std::vector<double> coolantTemperature; // Per fuel cell
+    std::vector<double> coolantVoid;        // Per fuel cell
+    std::vector<double> transfer;           // Scratch per fuel cell: g, then the heat flux
+    std::vector<double> effectiveness;      // Per fuel cell: e, after the heat capacity
+    std::vector<double> viscosity;          // Scratch per fuel cell
+    std::vector<double> conductivity;       // Scratch per fuel cell
+    std::vector<double> channelOutlet;
+    std::vector<double> channelPeakFlux;
+    double maxOutletTemperature = 0.0;
+    double peakHeatFlux = 0.0;
+    double meanVoid = 0.0;
+
+    void updateChannels(Core& core);
+    void updateEffectiveness(double massFlux, double capacityRate);
+    [[nodiscard]] static double heatTransferCoefficient(double massFlux, double heatCapacity, double viscosity,
+                                                        double conductivity);
+    void updateVoid(Core& core, double channelFlow);
+};
+
+#endif // COOLANTCHANNELS_H
@@ -4,39 +4,60 @@
 
 
 #include "CoolantChunk.h"
+#include "WaterProperties.h"
+
+namespace {
+
+constexpr double pressure = WaterProperties::nominalPressure;
+
+} // namespace
 
 CoolantChunk::CoolantChunk(double temperature)
-    : temperature(temperature) {}
+    : enthalpy(WaterProperties::get().lookup(WaterProperties::Property::Enthalpy, pressure, temperature)) {}
+
+CoolantChunk CoolantChunk::fromEnthalpy(double enthalpy) {
+    CoolantChunk chunk;
+    chunk.enthalpy = enthalpy;
+    return chunk;
+}
 
 double CoolantChunk::getTemperature() const {
-    return temperature;
+    return WaterProperties::get().temperature(pressure, enthalpy);
 }
 
 void CoolantChunk::setTemperature(double temp) {
-    temperature = temp;
+    enthalpy = WaterProperties::get().lookup(WaterProperties::Property::Enthalpy, pressure, temp);
 }
 
 void CoolantChunk::absorbHeat(double heatEnergy) {
-    // Update temperature based on absorbed heat
+    // Update enthalpy based on absorbed heat; the temperature follows from it
+    enthalpy += heatEnergy / mass;
+}
 
-    double specificHeatCapacity = 4200.0; // J/kg*K for water
-    double mass = 1.0; // Assume unit mass for simplicity
+double CoolantChunk::temperatureChange(double heatEnergy, double temperature) {
+    CoolantChunk chunk(temperature);
+    chunk.absorbHeat(heatEnergy);
+    return chunk.getTemperature() - temperature;
+}
 
-    double deltaT = heatEnergy / (mass * specificHeatCapacity);
-    temperature += deltaT;
+double CoolantChunk::getQuality() const {
+    return WaterProperties::get().saturation(pressure).quality(enthalpy);
 }
 
 double CoolantChunk::getDensity() const {
-    // Simplified linear model for density as a function of temperature
-    return density0 - beta * (temperature - T0);
+    const WaterProperties& properties = WaterProperties::get();
+    const WaterProperties::Saturation saturation = properties.saturation(pressure);
+    const double quality = saturation.quality(enthalpy);
+    if (quality > 0.0 && quality < 1.0) {
+        return 1.0 / (quality / saturation.vapourDensity + (1.0 - quality) / saturation.liquidDensity);
+    }
+    return properties.lookup(WaterProperties::Property::Density, pressure, getTemperature());
 }
 
-double CoolantChunk::getHeatCapacity() {
-    // Simplified model or empirical data
-    return 4182.0; // J/(kg·K) for water, adjust as needed
+double CoolantChunk::getHeatCapacity() const {
+    return WaterProperties::get().lookup(WaterProperties::Property::HeatCapacity, pressure, getTemperature());
 }
 
-double CoolantChunk::getViscosity() {
-    // Simplified model or empirical data
-    return 0.001; // Pa·s, adjust as needed
-}
\ No newline at end of file
+double CoolantChunk::getViscosity() const {
+    return WaterProperties::get().lookup(WaterProperties::Property::Viscosity, pressure, getTemperature());
+}
@@ -7,28 +7,37 @@
 
 
 
+// A chunk of primary coolant at the primary system pressure. Its state is the specific
+// enthalpy, so heat added past saturation boils it (quality rises at Tsat) instead of
+// raising the temperature without limit.
 class CoolantChunk {
 public:
     explicit CoolantChunk(double temperature);
+    static CoolantChunk fromEnthalpy(double enthalpy);
 
     //Getters and Setters
     [[nodiscard]] double getTemperature() const;
     void setTemperature(double temperature);
+    [[nodiscard]] double getEnthalpy() const { return enthalpy; } // J/kg
+    void setEnthalpy(double specificEnthalpy) { enthalpy = specificEnthalpy; }
 
     //Methods
     void absorbHeat(double heatEnergy);
+    [[nodiscard]] static double temperatureChange(double heatEnergy, double temperature); // Of a chunk at temperature absorbing heatEnergy
 
+    // Water properties at primary system pressure (WaterProperties tables). Density is the
+    // homogeneous mixture density while boiling.
+    [[nodiscard]] double getQuality() const;
     [[nodiscard]] double getDensity() const;
-    [[nodiscard]] static double getHeatCapacity() ;
-    [[nodiscard]] static double getViscosity() ;
+    [[nodiscard]] double getHeatCapacity() const;
+    [[nodiscard]] double getViscosity() const;
 
 private:
-    double temperature;
+    double enthalpy;
 
-    // Constants for property calculations
-    static constexpr double density0 = 1000.0; // kg/m^3 at T0
-    static constexpr double beta = 0.3;        // Coefficient for density change
-    static constexpr double T0 = 300.0;        // Reference temperature
+    static constexpr double mass = 1.0; // kg, unit mass for simplicity
+
+    CoolantChunk() : enthalpy(0.0) {}
 };
 
 
@@ -5,49 +5,318 @@
 // CoolantLoop.cpp
 
 #include "CoolantLoop.h"
+#include "WaterProperties.h"
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
 
 CoolantLoop::CoolantLoop(int chunkCount)
-    : hasLeak(false) {
+    : breakArea(0.0), heatLossRate(0.0), massFlowRate(nominalMassFlowRate), pumpTripped(false),
+      pressurizerMass(nominalPressurizerLevel * pressurizerCapacity), pressure(WaterProperties::nominalPressure),
+      breakFlowRate(0.0), passageDistance(0.0), inventory(0.0), inventoryLost(false), head(0), steamGenerator(std::max(1, chunkCount / 4)) {
     // Initialize coolant chunks with initial temperature
-    for (int i = 0; i < chunkCount; ++i) {
-        chunks.emplace_back(300.0); // Starting temperature 300K
+    enthalpies.assign(chunkCount, CoolantChunk(300.0).getEnthalpy()); // Starting temperature 300K
+    masses.assign(chunkCount, chunkMass);
+    updateInventory();
+}
+
+void CoolantLoop::advance(double deltaTime, double coreHeat) {
+    const double maxSubsteps = static_cast<double>(std::max<std::size_t>(1, enthalpies.size()));
+    const int substeps = static_cast<int>(std::clamp(std::ceil(massFlowRate * deltaTime / chunkMass), 1.0, maxSubsteps));
+    const double substepTime = deltaTime / substeps;
+
+    // The passage and the break flow cover the whole step
+    double moved = 0.0;
+    double discharged = 0.0;
+    for (int i = 0; i < substeps; ++i) {
+        advanceLoop(substepTime);
+        absorbPassageHeat(getUpperChunk(), coreHeat / substeps);
+        updateCoolantChunks(substepTime);
+        moved += passageDistance;
+        discharged += breakFlowRate;
+    }
+    passageDistance = moved;
+    breakFlowRate = discharged / substeps;
+}
+
+void CoolantLoop::advanceLoop(double deltaTime) {
+    if (pumpTripped) {
+        massFlowRate *= std::exp(-deltaTime / pumpCoastdownTime);
+    }
+
+    double distance = massFlowRate * deltaTime / chunkMass;
+    breakFlowRate = 0.0;
+    if (breakArea > 0.0 && !masses.empty()) {
+        distance = discharge(distance, deltaTime);
+    }
+
+    transport(distance);
+    passageDistance = std::max(0.0, distance);
+}
+
+double CoolantLoop::discharge(double distance, double deltaTime) {
+    // Critical flow out of the break at the current pressure and the density at the break
+    const std::size_t breakChunk = getBreakChunk();
+    const double density = CoolantChunk::fromEnthalpy(enthalpies[slot(breakChunk)]).getDensity();
+    const double massFlux = dischargeCoefficient * std::sqrt(2.0 * density * std::max(0.0, pressure - backPressure));
+    const double breakDistance = massFlux * breakArea * deltaTime / chunkMass;
+
+    // The chunks that pass the break this step, the last one in part. The break draws water
+    // toward itself, so the loop moves at least at the break flow once the pumps have stopped.
+    // Each chunk loses mass at G * A per full chunk mass for the time it spends at the break.
+    const double window = std::min(std::max(distance, breakDistance), static_cast<double>(masses.size()));
+    if (window <= 0.0) {
+        return distance;
+    }
+    const double rate = breakDistance / window;
+    const auto windowChunks = static_cast<std::size_t>(std::ceil(window));
+
+    // The pressurizer makes up what it can, entering as saturated liquid
+    double drained = 0.0;
+    for (std::size_t k = 0; k < windowChunks; ++k) {
+        const double overlap = std::min(1.0, window - static_cast<double>(k));
+        drained += masses[slot(breakChunk + k)] * (1.0 - std::exp(-rate * overlap));
+    }
+    const double makeup = std::min(drained, pressurizerMass);
+    const double makeupShare = drained > 0.0 ? makeup / drained : 0.0;
+    const double makeupEnthalpy = WaterProperties::get().saturation(WaterProperties::nominalPressure).liquidEnthalpy;
+    pressurizerMass -= makeup;
+
+    for (std::size_t k = 0; k < windowChunks; ++k) {
+        const std::size_t s = slot(breakChunk + k);
+        const double overlap = std::min(1.0, window - static_cast<double>(k));
+        const double loss = masses[s] * (1.0 - std::exp(-rate * overlap));
+        const double refill = makeupShare * loss;
+        const double remaining = masses[s] - loss;
+        masses[s] = remaining + refill;
+        if (masses[s] > 0.0) {
+            enthalpies[s] = (remaining * enthalpies[s] + refill * makeupEnthalpy) / masses[s];
+        }
+    }
+    breakFlowRate = drained / deltaTime;
+    inventoryLost = inventoryLost || makeup < drained;
+    updateInventory();
+    updatePressure();
+    return std::max(distance, breakDistance);
+}
+
+void CoolantLoop::updatePressure() {
+    // The steam space (pressurizer bubble plus the voided loop) expands as water leaves
+    const double steamSpace = pressurizerCapacity - pressurizerMass + chunkMass * masses.size() - inventory;
+    const double nominalSteamSpace = pressurizerCapacity * (1.0 - nominalPressurizerLevel);
+    double expanded = WaterProperties::nominalPressure
+                      * std::pow(nominalSteamSpace / std::max(steamSpace, nominalSteamSpace), polytropicExponent);
+
+    // Hot water flashes and holds the pressure at its saturation pressure
+    if (inventory > 0.0) {
+        double energy = 0.0;
+        for (std::size_t s = 0; s < masses.size(); ++s) {
+            energy += masses[s] * enthalpies[s];
+        }
+        const double temperature =
+            WaterProperties::get().temperature(WaterProperties::nominalPressure, energy / inventory);
+        expanded = std::max(expanded, WaterProperties::saturationPressure(std::min(temperature, 647.0)));
+    }
+    pressure = std::clamp(expanded, backPressure, WaterProperties::nominalPressure);
+}
+
+void CoolantLoop::updateInventory() {
+    inventory = 0.0;
+    for (double mass : masses) {
+        inventory += mass;
+    }
+}
+
+void CoolantLoop::transport(double distance) {
+    const std::size_t count = enthalpies.size();
+    if (count == 0 || distance <= 0.0) {
+        return;
+    }
+
+    // Whole chunks: move the head; the chunks themselves stay in place
+    double whole = std::floor(distance);
+    double fraction = distance - whole;
+    head = (head + static_cast<std::size_t>(std::fmod(whole, static_cast<double>(count)))) % count;
+
+    // Fraction: upwind sweep, each chunk takes in part of its upstream neighbour. Upstream of
+    // chunk i is chunk i + 1, which is also the next storage slot, so the sweep ignores head.
+    if (fraction <= 0.0) {
+        return;
+    }
+    if (!inventoryLost) {
+        const double first = enthalpies[0];
+        for (std::size_t s = 0; s + 1 < count; ++s) {
+            enthalpies[s] += fraction * (enthalpies[s + 1] - enthalpies[s]);
+        }
+        enthalpies[count - 1] += fraction * (first - enthalpies[count - 1]);
+        return;
+    }
+
+    // With voided chunks the sweep carries mass and energy (mass * enthalpy) alike
+    auto advect = [&](std::size_t s, double upstreamMass, double upstreamEnergy) {
+        const double energy = masses[s] * enthalpies[s];
+        masses[s] += fraction * (upstreamMass - masses[s]);
+        if (masses[s] > 0.0) {
+            enthalpies[s] = (energy + fraction * (upstreamEnergy - energy)) / masses[s];
+        }
+    };
+    const double firstMass = masses[0];
+    const double firstEnergy = masses[0] * enthalpies[0];
+    for (std::size_t s = 0; s + 1 < count; ++s) {
+        advect(s, masses[s + 1], masses[s + 1] * enthalpies[s + 1]);
+    }
+    advect(count - 1, firstMass, firstEnergy);
+}
+
+void CoolantLoop::updateCoolantChunks(double deltaTime) {
+    // Ambient losses from the piping (order does not matter, so sweep storage)
+    if (heatLossRate != 0.0) {
+        const double enthalpyLoss = heatLossRate * deltaTime / chunkMass;
+        for (double& enthalpy : enthalpies) {
+            enthalpy -= enthalpyLoss;
+        }
+    }
+
+    // Steam generator: gather the tube segment (it may wrap in storage), exchange, scatter back
+    auto [first, count] = getSteamGeneratorChunks();
+    tubeEnthalpy.resize(count);
+    tubeMass.resize(count);
+    for (std::size_t j = 0; j < count; ++j) {
+        tubeEnthalpy[j] = enthalpies[slot(first + j)];
+        tubeMass[j] = masses[slot(first + j)];
+    }
+    steamGenerator.exchangeHeat(tubeEnthalpy, tubeMass, chunkMass, WaterProperties::nominalPressure, deltaTime);
+    for (std::size_t j = 0; j < count; ++j) {
+        enthalpies[slot(first + j)] = tubeEnthalpy[j];
+    }
+}
+
+std::pair<std::size_t, std::size_t> CoolantLoop::getSteamGeneratorChunks() const {
+    // Centred in the leg from the core outlet (upper chunk) back down to the inlet (chunk 0).
+    // Coolant moves toward chunk 0, so the lowest chunk is the tubes' cold end.
+    const std::size_t leg = getUpperChunk() > 1 ? getUpperChunk() - 1 : 0;
+    const std::size_t count = std::min(static_cast<std::size_t>(steamGenerator.getNodeCount()), leg);
+    return { 1 + (leg - count) / 2, count };
+}
+
+double CoolantLoop::getTemperature(std::size_t chunk) const {
+    if (isDrained()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return WaterProperties::get().temperature(WaterProperties::nominalPressure, enthalpies[slot(chunk)]);
+}
+
+double CoolantLoop::getEnthalpy(std::size_t chunk) const {
+    if (isDrained()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return enthalpies[slot(chunk)];
+}
+
+void CoolantLoop::setEnthalpy(std::size_t chunk, double enthalpy) {
+    if (!isDrained()) {
+        enthalpies[slot(chunk)] = enthalpy;
+    }
+}
+
+void CoolantLoop::absorbHeat(std::size_t chunk, double heatEnergy) {
+    if (!isDrained()) {
+        const std::size_t s = slot(chunk);
+        enthalpies[s] += heatEnergy / std::max(masses[s], minimumChunkMass);
     }
 }
 
-void CoolantLoop::advanceLoop() {
-    if (hasLeak && !chunks.empty()) {
-        // Remove a chunk to simulate coolant loss
-        chunks.pop_back();
+double CoolantLoop::getPassageMass(std::size_t chunk) const {
+    if (passageDistance <= 0.0) {
+        return 0.0;
     }
+    double mass = 0.0;
+    visitPassage(chunk, [&](std::size_t s, double overlap) { mass += overlap * masses[s]; });
+    return mass;
+}
 
-    // Simulate coolant movement by rotating the chunks
-    if (!chunks.empty()) {
-        CoolantChunk frontChunk = chunks.front();
-        chunks.pop_front();
-        chunks.push_back(frontChunk);
+double CoolantLoop::getPassageEnthalpy(std::size_t chunk) const {
+    if (isDrained()) {
+        return std::numeric_limits<double>::quiet_NaN();
     }
+    double mass = 0.0, energy = 0.0;
+    visitPassage(chunk, [&](std::size_t s, double overlap) {
+        mass += overlap * masses[s];
+        energy += overlap * masses[s] * enthalpies[s];
+    });
+    return mass > 0.0 ? energy / mass : enthalpies[slot(chunk)];
 }
 
-void CoolantLoop::updateCoolantChunks() {
-    // Simulate heat exchange in the steam generator
-    double heatLossPerChunk = 5000.0; // Arbitrary value representing heat given to the secondary loop
+void CoolantLoop::absorbPassageHeat(std::size_t chunk, double heatEnergy) {
+    if (isDrained()) {
+        return;
+    }
+    double mass = 0.0;
+    visitPassage(chunk, [&](std::size_t s, double overlap) { mass += overlap * masses[s]; });
+    const double rise = heatEnergy / std::max(mass, minimumChunkMass);
+    visitPassage(chunk, [&](std::size_t s, double overlap) { enthalpies[s] += overlap * rise; });
+}
 
-    for (auto& chunk : chunks) {
-        chunk.absorbHeat(-heatLossPerChunk); // Negative heat to represent cooling
+void CoolantLoop::mixPassage(std::size_t chunk, double enthalpy) {
+    if (isDrained() || passageDistance <= 0.0) {
+        return;
     }
+    visitPassage(chunk, [&](std::size_t s, double overlap) { enthalpies[s] += overlap * (enthalpy - enthalpies[s]); });
 }
 
-CoolantChunk& CoolantLoop::getUpperChunk() {
-    // Assuming upper chunk is at index chunks.size() / 2
-    std::size_t index = chunks.size() / 2;
-    return chunks[index];
+std::array<std::span<const double>, 2> CoolantLoop::getEnthalpySpans() const {
+    std::span<const double> all(enthalpies);
+    return { all.subspan(head), all.first(head) };
 }
 
-CoolantChunk& CoolantLoop::getLowerChunk() {
-    // Assuming lower chunk is at index 0
-    return chunks.front();
+void CoolantLoop::copyTemperatures(std::vector<double>& out) const {
+    out.resize(enthalpies.size());
+    std::span<double> remaining(out);
+    for (const auto& span : getEnthalpySpans()) {
+        WaterProperties::get().temperatures(WaterProperties::nominalPressure, span, remaining);
+        remaining = remaining.subspan(span.size());
+    }
+}
+
+void CoolantLoop::captureState(std::vector<double>& state) const {
+    state.push_back(breakArea);
+    state.push_back(massFlowRate);
+    state.push_back(pumpTripped ? 1.0 : 0.0);
+    state.push_back(pressurizerMass);
+    state.push_back(pressure);
+    state.push_back(breakFlowRate);
+    steamGenerator.captureState(state);
+    for (const auto& span : getEnthalpySpans()) {
+        state.insert(state.end(), span.begin(), span.end());
+    }
+    std::span<const double> allMasses(masses);
+    for (const auto& span : { allMasses.subspan(head), allMasses.first(head) }) {
+        state.insert(state.end(), span.begin(), span.end());
+    }
 }
 
-void CoolantLoop::setLeak(bool cond) {
-    hasLeak = cond;
+bool CoolantLoop::restoreState(const double* state, std::size_t size) {
+    if (size != getStateSize()) {
+        return false;
+    }
+    const std::size_t headerSize = stateHeaderSize + steamGenerator.getStateSize();
+
+    breakArea = state[0];
+    massFlowRate = state[1];
+    pumpTripped = state[2] != 0.0;
+    pressurizerMass = state[3];
+    pressure = state[4];
+    breakFlowRate = state[5];
+    steamGenerator.restoreState(state + stateHeaderSize);
+
+    // Chunks were captured in loop order, so the ring restarts at slot 0
+    const std::size_t count = masses.size();
+    std::copy(state + headerSize, state + headerSize + count, enthalpies.begin());
+    std::copy(state + headerSize + count, state + size, masses.begin());
+    head = 0;
+    passageDistance = 0.0;
+    inventoryLost = std::any_of(masses.begin(), masses.end(), [](double mass) { return mass < chunkMass; });
+    updateInventory();
+    return true;
 }
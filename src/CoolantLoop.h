@@ -4,30 +4,172 @@
 
 #ifndef COOLANTLOOP_H
 #define COOLANTLOOP_H
-#include <deque>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
 
 #include "CoolantChunk.h"
+#include "SteamGenerator.h"
 
 
+// The loop is a ring of chunk specific enthalpies (J/kg) in one contiguous buffer; a chunk's
+// temperature follows from the water property tables at primary pressure. Chunk 0 (the lower,
+// core-inlet chunk) sits at the head index, and coolant flows from chunk i + 1 into chunk i.
+//
+// Transport follows the pump's mass flow rate: a step moves massFlowRate * dt / chunkMass
+// chunks. Whole chunks move the head (exact and free); the remaining fraction is a first-order
+// upwind advection sweep over the ring, so transit times are right for any step size. A step
+// runs in substeps of at most one chunk, each taking its share of the core heat at the outlet
+// and then exchanging with the steam generator. The inlet plenum mixes with every chunk that
+// passed it during the step (the passage), not just the one sitting there.
+//
+// A second ring of the same layout holds each chunk's mass (chunkMass when full). A break in
+// the cold leg discharges at the critical flow rate G = Cd sqrt(2 rho (p - p_back)), first
+// made up from the pressurizer and then drained from the chunks that flow past the break
+// during the step (at least at the break flow itself). Each of those loses an exponential
+// fraction of its mass set by the time it spends at the break, so the discharge is the same
+// for any step size. The chunk count never changes; a loop has drained once little of its
+// water is left.
 class CoolantLoop {
 public:
+    static constexpr double chunkMass = 1.0;           // kg of coolant per full chunk
+    static constexpr double nominalMassFlowRate = 30.0; // kg/s, about one chunk per 33 ms step
+    static constexpr double pumpCoastdownTime = 5.0;   // s, flow e-folding time after a pump trip
+
+    static constexpr double defaultBreakArea = 3.0e-4;     // m^2, about 2 cm across
+    static constexpr double dischargeCoefficient = 0.61;
+    static constexpr double backPressure = 101325.0;      // Pa, containment
+    static constexpr double pressurizerCapacity = 20.0;   // kg, this loop's share
+    static constexpr double nominalPressurizerLevel = 0.5;
+    static constexpr double polytropicExponent = 1.3;     // Steam space expansion
+    static constexpr double minimumChunkMass = 0.05;      // kg, floor for heat added to a voided chunk
+    static constexpr double drainedFraction = 0.05;       // Of the full loop inventory
+
     CoolantLoop(int chunkCount);
 
-    void advanceLoop();
-    void updateCoolantChunks();
-    CoolantChunk& getUpperChunk();
-    CoolantChunk& getLowerChunk();
+    // One step of transport, break, core heat and steam generator, in substeps that each move
+    // at most one chunk, so every chunk spends its own transit time at the core outlet and in
+    // each tube node at any step size. The core heat (J over the step) enters in even shares.
+    void advance(double deltaTime, double coreHeat = 0.0);
+    void advanceLoop(double deltaTime);
+    void updateCoolantChunks(double deltaTime);
+
+    // Moves the coolant by a number of chunks (whole chunks and an upwind fraction)
+    void transport(double distance);
+
+    // The pump moves chunks; the mass it moves falls with the loop's inventory
+    [[nodiscard]] double getMassFlowRate() const { return isDrained() ? 0.0 : massFlowRate * getInventoryFraction(); }
+    void setMassFlowRate(double rate) { massFlowRate = rate; }
+    [[nodiscard]] double getFlowFraction() const { return getMassFlowRate() / nominalMassFlowRate; }
+    void tripPump() { pumpTripped = true; }
+    [[nodiscard]] bool isPumpTripped() const { return pumpTripped; }
+
+    // Chunk i counted from the lower chunk. A drained loop reads NaN and absorbs nothing.
+    [[nodiscard]] double getTemperature(std::size_t chunk) const;
+    [[nodiscard]] double getEnthalpy(std::size_t chunk) const;
+    [[nodiscard]] double getMass(std::size_t chunk) const { return masses[slot(chunk)]; }
+    void setEnthalpy(std::size_t chunk, double enthalpy);
+    void absorbHeat(std::size_t chunk, double heatEnergy);
+    [[nodiscard]] std::size_t getUpperChunk() const { return enthalpies.size() / 2; }
+    [[nodiscard]] std::size_t getLowerChunk() const { return 0; }
+
+    // The passage of a chunk position: the chunks that passed it during the last step, the one
+    // now there and those downstream, each weighted by its mass and the part of it that passed.
+    // A stagnant loop's passage is the chunk itself. Heat raises every chunk of the passage by
+    // the same enthalpy, and mixing moves each toward the given enthalpy by the part that passed.
+    [[nodiscard]] double getPassageMass(std::size_t chunk) const;     // kg moved past it, 0 if stagnant
+    [[nodiscard]] double getPassageEnthalpy(std::size_t chunk) const; // NaN when drained
+    void absorbPassageHeat(std::size_t chunk, double heatEnergy);
+    void mixPassage(std::size_t chunk, double enthalpy);
 
-    void setLeak(bool cond);
+    // Chunk enthalpies in loop order as (at most) two contiguous spans, as the ring wraps once
+    [[nodiscard]] std::array<std::span<const double>, 2> getEnthalpySpans() const;
+    void copyTemperatures(std::vector<double>& out) const; // In loop order, one batched lookup per span
 
-    int getChunkCount() const { return chunks.size(); }
+    // Loss of coolant: a cold-leg break of the given flow area (0 closes it)
+    void setLeak(bool cond) { setBreakArea(cond ? defaultBreakArea : 0.0); }
+    void setBreakArea(double area) { breakArea = area; }
+    [[nodiscard]] double getBreakArea() const { return breakArea; }
+    [[nodiscard]] std::size_t getBreakChunk() const { return getSteamGeneratorChunks().first / 2; }
+    [[nodiscard]] double getBreakFlowRate() const { return breakFlowRate; } // kg/s over the last step
+
+    // Mass inventory (kg, chunks only), the pressurizer and the primary pressure. The pressure
+    // falls as the steam space (pressurizer bubble and voided chunks) expands, but not below
+    // the saturation pressure of the loop's mean temperature, where the water flashes. Water
+    // properties stay at nominal pressure throughout.
+    [[nodiscard]] double getInventory() const { return inventory; }
+    [[nodiscard]] double getInventoryFraction() const { return inventory / (chunkMass * masses.size()); }
+    [[nodiscard]] bool isDrained() const { return masses.empty() || getInventoryFraction() < drainedFraction; }
+    [[nodiscard]] double getPressurizerLevel() const { return pressurizerMass / pressurizerCapacity; }
+    [[nodiscard]] double getPressure() const { return pressure; }
+
+    // Ambient heat lost by each chunk per second, on top of the steam generator (default 0 J/s)
+    void setHeatLossRate(double rate) { heatLossRate = rate; }
+    [[nodiscard]] double getHeatLossRate() const { return heatLossRate; }
+
+    // The steam generator's tubes hold a run of chunks in the leg from the core outlet back to
+    // the inlet: (first chunk, count), with the first chunk at the tubes' cold end
+    [[nodiscard]] SteamGenerator& getSteamGenerator() { return steamGenerator; }
+    [[nodiscard]] const SteamGenerator& getSteamGenerator() const { return steamGenerator; }
+    [[nodiscard]] std::pair<std::size_t, std::size_t> getSteamGeneratorChunks() const;
+
+    // Session history snapshots (appended to / read from a flat buffer). restoreState leaves
+    // the loop untouched and returns false if the snapshot is not getStateSize() values.
+    [[nodiscard]] std::size_t getStateSize() const {
+        return stateHeaderSize + steamGenerator.getStateSize() + 2 * masses.size();
+    }
+    void captureState(std::vector<double>& state) const;
+    bool restoreState(const double* state, std::size_t size);
+
+    int getChunkCount() const { return static_cast<int>(enthalpies.size()); }
     std::mutex& getMutex() const { return coolantMutex; }
-    const std::deque<CoolantChunk>& getChunks() const { return chunks; }
 
 private:
-    bool hasLeak;
-    std::deque<CoolantChunk> chunks;
+    double breakArea;
+    double heatLossRate;
+    double massFlowRate;
+    bool pumpTripped;
+    double pressurizerMass;
+    double pressure;
+    double breakFlowRate;
+    double passageDistance; // Chunks moved by the last step
+    double inventory;
+    bool inventoryLost; // Some chunk is below full mass, so transport weighs by mass
+    std::vector<double> enthalpies; // Ring buffer, chunk i at (head + i) % size
+    std::vector<double> masses;     // Same layout
+    std::size_t head;
+    SteamGenerator steamGenerator;
+    std::vector<double> tubeEnthalpy, tubeMass; // Scratch: the chunks in the steam generator, cold end first
     mutable std::mutex coolantMutex;
+
+    [[nodiscard]] std::size_t slot(std::size_t chunk) const {
+        std::size_t position = head + chunk;
+        return position < enthalpies.size() ? position : position - enthalpies.size();
+    }
+    double discharge(double distance, double deltaTime); // Returns the distance to transport
+
+    // Calls visit(slot, overlap) for each chunk of a passage, the last one in part
+    template <typename Visit>
+    void visitPassage(std::size_t chunk, Visit visit) const {
+        const std::size_t count = enthalpies.size();
+        const double window = std::min(passageDistance, static_cast<double>(count));
+        if (window <= 0.0) {
+            visit(slot(chunk), 1.0);
+            return;
+        }
+        for (std::size_t k = 0; static_cast<double>(k) < window; ++k) {
+            visit(slot((chunk + count - k) % count), std::min(1.0, window - static_cast<double>(k)));
+        }
+    }
+    void updateInventory();
+    void updatePressure();
+
+    // breakArea, massFlowRate, pumpTripped, pressurizerMass, pressure, breakFlowRate
+    static constexpr std::size_t stateHeaderSize = 6;
 };
 
 
@@ -0,0 +1,236 @@
+// CoolantSystem.cpp
+
+#include "CoolantSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include "WaterProperties.h"
+#include "WorkerPool.h"
+
+CoolantSystem::CoolantSystem(int loopCount, int chunksPerLoop)
+    : chunksPerLoop(chunksPerLoop) {
+    loops.reserve(std::max(1, loopCount));
+    for (int i = 0; i < std::max(1, loopCount); ++i) {
+        loops.push_back(std::make_unique<CoolantLoop>(chunksPerLoop));
+    }
+}
+
+void CoolantSystem::advance(double deltaTime, double coreHeat, WorkerPool* pool) {
+    std::vector<double> weights;
+    flowWeights(weights);
+
+    auto advanceLoop = [&](std::size_t i) {
+        CoolantLoop& loop = *loops[i];
+        std::lock_guard<std::mutex> lock(loop.getMutex());
+        loop.advance(deltaTime, coreHeat * weights[i]);
+    };
+
+    if (pool && loops.size() > 1) {
+        pool->parallelFor(loops.size(), advanceLoop);
+    } else {
+        for (std::size_t i = 0; i < loops.size(); ++i) {
+            advanceLoop(i);
+        }
+    }
+
+    if (loops.size() > 1) {
+        mixInletPlenum();
+    }
+}
+
+void CoolantSystem::mixInletPlenum() {
+    // Every chunk that reached the plenum this step (the lower chunk's passage) pours into it,
+    // and each takes back mixed water in proportion to the part of it that passed, so the
+    // exchange conserves energy and covers all the water that moved, whatever the step
+    std::vector<double> masses(loops.size(), 0.0);
+    std::vector<double> enthalpies(loops.size(), 0.0);
+    double totalMass = 0.0;
+    for (std::size_t i = 0; i < loops.size(); ++i) {
+        std::lock_guard<std::mutex> lock(loops[i]->getMutex());
+        if (loops[i]->isDrained()) {
+            continue;
+        }
+        masses[i] = loops[i]->getPassageMass(loops[i]->getLowerChunk());
+        enthalpies[i] = loops[i]->getPassageEnthalpy(loops[i]->getLowerChunk());
+        totalMass += masses[i];
+    }
+    if (totalMass <= 0.0) {
+        return;
+    }
+
+    double plenumEnthalpy = 0.0;
+    for (std::size_t i = 0; i < loops.size(); ++i) {
+        plenumEnthalpy += masses[i] / totalMass * enthalpies[i];
+    }
+
+    for (std::size_t i = 0; i < loops.size(); ++i) {
+        if (masses[i] > 0.0) {
+            std::lock_guard<std::mutex> lock(loops[i]->getMutex());
+            loops[i]->mixPassage(loops[i]->getLowerChunk(), plenumEnthalpy);
+        }
+    }
+}
+
+void CoolantSystem::flowWeights(std::vector<double>& weights) const {
+    weights.assign(loops.size(), 0.0);
+    std::vector<bool> filled(loops.size(), false);
+    double totalFlow = 0.0;
+    int filledLoops = 0;
+    for (std::size_t i = 0; i < loops.size(); ++i) {
+        std::lock_guard<std::mutex> lock(loops[i]->getMutex());
+        if (!loops[i]->isDrained()) {
+            filled[i] = true;
+            weights[i] = loops[i]->getMassFlowRate();
+            totalFlow += weights[i];
+            ++filledLoops;
+        }
+    }
+
+    for (std::size_t i = 0; i < loops.size(); ++i) {
+        if (totalFlow > 0.0) {
+            weights[i] /= totalFlow;
+        } else if (filled[i]) {
+            weights[i] = 1.0 / filledLoops;
+        }
+    }
+}
+
+double CoolantSystem::weightedEnthalpy(bool upper) const {
+    std::vector<double> weights;
+    flowWeights(weights);
+
+    double enthalpy = 0.0;
+    bool any = false;
+    for (std::size_t i = 0; i < loops.size(); ++i) {
+        if (weights[i] <= 0.0) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(loops[i]->getMutex());
+        const CoolantLoop& loop = *loops[i];
+        enthalpy += weights[i] * loop.getPassageEnthalpy(upper ? loop.getUpperChunk() : loop.getLowerChunk());
+        any = true;
+    }
+    return any ? enthalpy : std::numeric_limits<double>::quiet_NaN();
+}
+
+namespace {
+
+double temperatureOf(double enthalpy) {
+    return std::isnan(enthalpy) ? enthalpy : WaterProperties::get().temperature(WaterProperties::nominalPressure, enthalpy);
+}
+
+} // namespace
+
+double CoolantSystem::getOutletTemperature() const {
+    return temperatureOf(weightedEnthalpy(true));
+}
+
+double CoolantSystem::getInletTemperature() const {
+    return temperatureOf(weightedEnthalpy(false));
+}
+
+double CoolantSystem::getInletEnthalpy() const {
+    return weightedEnthalpy(false);
+}
+
+double CoolantSystem::getMassFlowRate() const {
+    double flow = 0.0;
+    for (const auto& loop : loops) {
+        std::lock_guard<std::mutex> lock(loop->getMutex());
+        flow += loop->getMassFlowRate();
+    }
+    return flow;
+}
+
+double CoolantSystem::getFlowFraction() const {
+    return getMassFlowRate() / (CoolantLoop::nominalMassFlowRate * static_cast<double>(loops.size()));
+}
+
+int CoolantSystem::getChunkCount() const {
+    int count = 0;
+    for (const auto& loop : loops) {
+        std::lock_guard<std::mutex> lock(loop->getMutex());
+        count += loop->getChunkCount();
+    }
+    return count;
+}
+
+double CoolantSystem::getInventory() const {
+    double inventory = 0.0;
+    for (const auto& loop : loops) {
+        std::lock_guard<std::mutex> lock(loop->getMutex());
+        inventory += loop->getInventory();
+    }
+    return inventory;
+}
+
+double CoolantSystem::getPressurizerLevel() const {
+    double level = 0.0;
+    for (const auto& loop : loops) {
+        std::lock_guard<std::mutex> lock(loop->getMutex());
+        level += loop->getPressurizerLevel();
+    }
+    return level / static_cast<double>(loops.size());
+}
+
+double CoolantSystem::getSteamPower() const {
+    double power = 0.0;
+    for (const auto& loop : loops) {
+        std::lock_guard<std::mutex> lock(loop->getMutex());
+        power += loop->getSteamGenerator().getSteamPower();
+    }
+    return power;
+}
+
+void CoolantSystem::setHeatLossRate(double rate) {
+    for (auto& loop : loops) {
+        std::lock_guard<std::mutex> lock(loop->getMutex());
+        loop->setHeatLossRate(rate);
+    }
+}
+
+void CoolantSystem::setFeedwaterFlowRate(double rate) {
+    for (auto& loop : loops) {
+        std::lock_guard<std::mutex> lock(loop->getMutex());
+        loop->getSteamGenerator().setFeedwaterFlowRate(rate);
+    }
+}
+
+void CoolantSystem::captureState(std::vector<double>& state) const {
+    state.push_back(static_cast<double>(loops.size()));
+    for (const auto& loop : loops) {
+        std::lock_guard<std::mutex> lock(loop->getMutex());
+        std::size_t sizeIndex = state.size();
+        state.push_back(0.0);
+        loop->captureState(state);
+        state[sizeIndex] = static_cast<double>(state.size() - sizeIndex - 1);
+    }
+}
+
+bool CoolantSystem::restoreState(const double* state, std::size_t size) {
+    if (size < 1 || static_cast<std::size_t>(state[0]) != loops.size()) {
+        return false;
+    }
+
+    // Check every loop's framing first so a bad snapshot restores nothing
+    std::size_t offset = 1;
+    for (const auto& loop : loops) {
+        if (offset >= size || static_cast<std::size_t>(state[offset]) != loop->getStateSize()
+            || offset + 1 + loop->getStateSize() > size) {
+            return false;
+        }
+        offset += 1 + loop->getStateSize();
+    }
+
+    offset = 1;
+    for (auto& loop : loops) {
+        auto loopSize = static_cast<std::size_t>(state[offset]);
+        std::lock_guard<std::mutex> lock(loop->getMutex());
+        if (!loop->restoreState(state + offset + 1, loopSize)) {
+            return false;
+        }
+        offset += 1 + loopSize;
+    }
+    return true;
+}
@@ -0,0 +1,67 @@
+// CoolantSystem.h
+
+#ifndef COOLANTSYSTEM_H
+#define COOLANTSYSTEM_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "CoolantLoop.h"
+
+class WorkerPool;
+
+// The reactor coolant system: N primary loops (typically 2 to 4), each with its own ring of
+// chunks, pump and steam generator, joined at the core through a shared inlet plenum.
+//
+// Loops only interact through the core and the plenum, so a step shares the core heat out by
+// mass flow, advances the loops independently (on the worker pool when one is given) and then
+// mixes their returning cold legs in the plenum in a short serial pass. Each loop keeps its
+// own mutex and no call holds more than one of them at a time.
+class CoolantSystem {
+public:
+    CoolantSystem(int loopCount, int chunksPerLoop);
+
+    // Transport, core heat and steam generator heat transfer in every loop, then inlet plenum
+    // mixing. The core heat (J over the step) is split across loops by mass flow; each loop's
+    // share enters the water passing its upper (core outlet, hot leg) chunk as the step goes,
+    // and the lower (core inlet) chunk only warms as the loop carries it round.
+    void advance(double deltaTime, double coreHeat, WorkerPool* pool = nullptr);
+
+    [[nodiscard]] int getLoopCount() const { return static_cast<int>(loops.size()); }
+    [[nodiscard]] CoolantLoop& getLoop(int loop) { return *loops[loop]; }
+    [[nodiscard]] const CoolantLoop& getLoop(int loop) const { return *loops[loop]; }
+    [[nodiscard]] int getChunksPerLoop() const { return chunksPerLoop; }
+
+    // Plant readings; the enthalpies are flow-weighted over the loops, each the mean over the
+    // passage of its upper or lower chunk, and the temperatures are those of the mixed coolant
+    // (NaN once all have drained)
+    [[nodiscard]] double getMassFlowRate() const;
+    [[nodiscard]] double getFlowFraction() const; // Of the nominal flow of all loops together
+    [[nodiscard]] double getOutletTemperature() const;
+    [[nodiscard]] double getInletTemperature() const;
+    [[nodiscard]] double getInletEnthalpy() const;
+    [[nodiscard]] int getChunkCount() const; // Over all loops
+    [[nodiscard]] double getInventory() const; // kg of coolant in all loops
+    [[nodiscard]] double getPressurizerLevel() const; // Mean over the loops, 0.0 to 1.0
+    [[nodiscard]] double getSteamPower() const; // W, all steam generators
+
+    void setHeatLossRate(double rate);
+    void setFeedwaterFlowRate(double rate); // kg/s into each steam generator
+
+    // Session history snapshots: loop count, then each loop's state size and state
+    void captureState(std::vector<double>& state) const;
+    bool restoreState(const double* state, std::size_t size);
+
+private:
+    std::vector<std::unique_ptr<CoolantLoop>> loops;
+    int chunksPerLoop;
+
+    void mixInletPlenum();
+
+    // Each loop's share of the core flow (zero for drained loops; even split if nothing flows)
+    void flowWeights(std::vector<double>& weights) const;
+    [[nodiscard]] double weightedEnthalpy(bool upper) const;
+};
+
+#endif // COOLANTSYSTEM_H
@@ -3,10 +3,14 @@
 //
 
 #include "Core.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 Core::Core(int xSize, int ySize, int zSize)
-    : xSize(xSize), ySize(ySize), zSize(zSize), controlRodInsertion(0.0) {
+    : xSize(xSize), ySize(ySize), zSize(zSize), materialRevision(0), temperatureCoefficient(-0.0001),
+      voidCoefficient(-0.01), burnupElapsed(0.0), shapeRevision(~std::uint64_t{0}), shapeNeighborReactivity(0.0),
+      activeCellsValid(false) {
     elements.resize(xSize * ySize * zSize);
     initializeCore();
 }
@@ -27,218 +31,639 @@ void Core::initializeCore() {
             }
         }
     }
+    fluence.assign(elements.size(), 0.0);
+    burnupElapsed = 0.0;
+    pointKinetics.reset(1.0); // Every fuel element starts with a population of 1
+    initializeRodBanks();
+    invalidateActiveCells();
+}
+
+void Core::initializeRodBanks() {
+    // Rod columns on every other interior row and column, split into two interleaved banks
+    rodBanks.assign(2, RodBank());
+    for (int x = 1; x < xSize - 1; x += 2) {
+        for (int y = 1; y < ySize - 1; y += 2) {
+            rodBanks[(x / 2 + y / 2) % 2].columns.push_back(x * ySize + y);
+        }
+    }
 }
 
 void Core::calculateCoreThermals(double deltaTime) {
-    // Step 1: Calculate reactivity for each element
-#pragma omp parallel for collapse(3) schedule(static)
-    for (int x = 0; x < xSize; ++x) {
-        for (int y = 0; y < ySize; ++y) {
-            for (int z = 0; z < zSize; ++z) {
-                CoreElement& element = elements[index(x, y, z)];
+    updateActiveCells();
 
-                if (element.getMaterial() != MaterialType::Vessel) {
-                    auto neighbors = getNeighbors(x, y, z);
-                    element.calculateReactivity(neighbors);
-                }
-            }
-        }
+    // Step 1: Calculate reactivity for each non-vessel element (neighbor terms are cached)
+    const int reactiveCount = static_cast<int>(reactiveCells.size());
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < reactiveCount; ++i) {
+        elements[reactiveCells[i]].applyReactivity(neighborReactivity[i], temperatureCoefficient, voidCoefficient);
     }
 
     // Step 2: Update neutron population and temperature
-#pragma omp parallel for collapse(3) schedule(static)
-    for (int x = 0; x < xSize; ++x) {
-        for (int y = 0; y < ySize; ++y) {
-            for (int z = 0; z < zSize; ++z) {
-                CoreElement& element = elements[index(x, y, z)];
+    const int fuelCount = static_cast<int>(fuelCells.size());
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < fuelCount; ++i) {
+        CoreElement& element = elements[fuelCells[i]];
 
-                if (element.getMaterial() == MaterialType::Fuel) {
-                    double neutronPopulation = element.getNeutronPopulation();
-                    double reactivity = element.getReactivity();
+        double neutronPopulation = element.getNeutronPopulation();
+        double reactivity = element.getReactivity();
 
-                    // Simplified neutron population update
-                    double newNeutronPopulation = neutronPopulation * (1 + reactivity);
-                    element.setNeutronPopulation(newNeutronPopulation);
+        // Simplified neutron population update, at a rate so any step size agrees
+        double newNeutronPopulation = neutronPopulation * populationGrowth(reactivity, deltaTime);
+        element.setNeutronPopulation(newNeutronPopulation);
 
-                    // Heat generated is proportional to neutron population
-                    double heatGenerated = newNeutronPopulation * 1000.0; // Arbitrary scaling
+        // Heat generated is proportional to neutron population
+        double heatGenerated = newNeutronPopulation * 1000.0; // Arbitrary scaling
 
-                    // Update temperature
-                    element.updateTemperature(heatGenerated, deltaTime);
-                }
-            }
+        // Update temperature
+        element.updateTemperature(heatGenerated, deltaTime);
+    }
+}
+
+void Core::calculatePointKinetics(double deltaTime) {
+    updateActiveCells();
+    if (shapeRevision != materialRevision) {
+        updatePowerShape();
+    }
+
+    // Power-weighted mean of the spatial model's cell reactivity. It is linear in temperature
+    // and void, so the neighbor part is cached with the shape and only the means are summed.
+    double meanTemperature = 0.0;
+    double meanVoid = 0.0;
+    for (std::size_t i = 0; i < fuelCells.size(); ++i) {
+        meanTemperature += powerShape[i] * elements[fuelCells[i]].getTemperature();
+        meanVoid += powerShape[i] * elements[fuelCells[i]].getCoolantVoid();
+    }
+    double reactivity = shapeNeighborReactivity + temperatureCoefficient * (meanTemperature - 300.0)
+                      + voidCoefficient * meanVoid;
+
+    pointKinetics.advance(reactivity, deltaTime);
+
+    // Power relative to the initial core, where every fuel element holds a population of 1
+    const double totalPopulation = pointKinetics.getPower() * static_cast<double>(fuelCells.size());
+    for (std::size_t i = 0; i < fuelCells.size(); ++i) {
+        CoreElement& element = elements[fuelCells[i]];
+        double population = totalPopulation * powerShape[i];
+        element.setNeutronPopulation(population);
+
+        // Heat generated is proportional to neutron population (same scaling as the thermals)
+        element.updateTemperature(population * 1000.0, deltaTime);
+    }
+}
+
+void Core::updatePowerShape() {
+    // Cached from the last spatial flux; cells that left the fuel drop out
+    powerShape.assign(fuelCells.size(), 0.0);
+    double total = 0.0;
+    for (std::size_t i = 0; i < fuelCells.size(); ++i) {
+        for (int g = 0; g < numEnergyGroups; ++g) {
+            powerShape[i] += std::max(0.0, elements[fuelCells[i]].getNeutronFlux(g));
         }
+        total += powerShape[i];
+    }
+    shapeNeighborReactivity = 0.0;
+    for (std::size_t i = 0; i < fuelCells.size(); ++i) {
+        powerShape[i] = total > 0.0 ? powerShape[i] / total : 1.0 / static_cast<double>(powerShape.size());
+        shapeNeighborReactivity += powerShape[i] * neighborReactivity[reactiveSlot[fuelCells[i]]];
     }
+    shapeRevision = materialRevision;
 }
 
 void Core::updateNeutronPopulation() {
     // Additional neutron population updates can be implemented here if needed
 }
 
-void Core::insertControlRods() {
-    // Insert control rods to reduce reactivity
-
-    // For simplicity, insert control rods in every other column
-    for (int x = 1; x < xSize - 1; x += 2) {
-        for (int y = 1; y < ySize - 1; y += 2) {
-            for (int z = 1; z < zSize - 1; ++z) {
-                CoreElement& element = elements[index(x, y, z)];
-                if (element.getMaterial() == MaterialType::Fuel) {
-                    element = CoreElement(MaterialType::ControlRod, element.getTemperature());
-                }
-            }
+void Core::scram() {
+    for (auto& bank : rodBanks) {
+        if (bank.tripTime < 0.0) {
+            bank.tripTime = 0.0;
+            bank.velocity = 0.0;
+            bank.target = 1.0;
         }
     }
 }
 
+bool Core::isScrammed() const {
+    return std::any_of(rodBanks.begin(), rodBanks.end(), [](const RodBank& bank) { return bank.tripTime >= 0.0; });
+}
+
+bool Core::isScramComplete() const {
+    return isScrammed() && std::all_of(rodBanks.begin(), rodBanks.end(), [](const RodBank& bank) {
+        return bank.tripTime < 0.0 || bank.position >= 1.0;
+    });
+}
+
+bool Core::areRodsMoving() const {
+    return std::any_of(rodBanks.begin(), rodBanks.end(), [](const RodBank& bank) {
+        return bank.tripTime >= 0.0 ? bank.position < 1.0 : bank.position != bank.target;
+    });
+}
+
+double Core::getTimeSinceScram() const {
+    double time = -1.0;
+    for (const auto& bank : rodBanks) {
+        time = std::max(time, bank.tripTime);
+    }
+    return time;
+}
+
 std::vector<CoreElement>& Core::getElements() {
     return elements;
 }
 
-void Core::setControlRodInsertion(double insertionDepth) {
-    controlRodInsertion = insertionDepth;
+bool Core::setControlRodInsertion(double insertionDepth) {
+    bool moved = false;
+    for (int bank = 0; bank < getBankCount(); ++bank) {
+        moved = setBankInsertion(bank, insertionDepth) || moved;
+    }
+    return moved;
+}
 
-    // Update the material of elements based on insertion depth
-    // For simplicity, assume control rods insert from the top (z-direction)
-    int maxInsertionLevel = static_cast<int>(insertionDepth * zSize);
+bool Core::setBankInsertion(int bank, double insertionDepth) {
+    if (bank < 0 || bank >= getBankCount() || insertionDepth < 0.0 || insertionDepth > 1.0
+        || rodBanks[bank].tripTime >= 0.0) {
+        return false;
+    }
+    rodBanks[bank].target = insertionDepth;
+    return true;
+}
 
-    for (int x = 0; x < xSize; ++x) {
-        for (int y = 0; y < ySize; ++y) {
-            for (int z = zSize - 1; z >= zSize - maxInsertionLevel; --z) {
-                CoreElement& element = elements[index(x, y, z)];
-                if (element.getMaterial() == MaterialType::Fuel) {
-                    element.setMaterial(MaterialType::ControlRod);
-                }
-            }
+void Core::setRodSpeed(double fractionPerSecond) {
+    for (auto& bank : rodBanks) {
+        bank.speed = fractionPerSecond;
+    }
+}
+
+double Core::getControlRodInsertion() const {
+    if (rodBanks.empty()) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (const auto& bank : rodBanks) {
+        sum += bank.position;
+    }
+    return sum / static_cast<double>(rodBanks.size());
+}
+
+void Core::moveControlRods(double deltaTime) {
+    for (auto& bank : rodBanks) {
+        if (bank.tripTime >= 0.0) {
+            dropBank(bank, deltaTime);
+            continue;
+        }
+        if (bank.position == bank.target) {
+            continue;
         }
+
+        double position = bank.target;
+        double travel = bank.speed * deltaTime;
+        if (bank.speed > 0.0 && std::abs(bank.target - bank.position) > travel) {
+            position = bank.position + (bank.target > bank.position ? travel : -travel);
+        }
+        moveBank(bank, position);
     }
+}
 
-    // Reset elements above the insertion level back to fuel (if previously set to control rod)
-    for (int x = 0; x < xSize; ++x) {
-        for (int y = 0; y < ySize; ++y) {
-            for (int z = 0; z < zSize - maxInsertionLevel; ++z) {
-                CoreElement& element = elements[index(x, y, z)];
-                if (element.getMaterial() == MaterialType::ControlRod) {
-                    element.setMaterial(MaterialType::Fuel);
-                }
+void Core::dropBank(RodBank& bank, double deltaTime) {
+    double previousTripTime = bank.tripTime;
+    bank.tripTime += deltaTime;
+    if (bank.position >= 1.0 || bank.tripTime <= scramProfile.delay) {
+        return;
+    }
+
+    // Only the part of the step after the unlatch delay moves the rods
+    double falling = bank.tripTime - std::max(previousTripTime, scramProfile.delay);
+    bank.velocity = std::min(scramProfile.maxVelocity, bank.velocity + scramProfile.acceleration * falling);
+    moveBank(bank, std::min(1.0, bank.position + bank.velocity * falling));
+}
+
+int Core::layersAt(double position) const {
+    // Rods insert from the top (z-direction); the vessel layer counts as the first layer
+    return std::clamp(static_cast<int>(position * zSize), 0, zSize);
+}
+
+void Core::moveBank(RodBank& bank, double position) {
+    bank.position = position;
+    int layers = layersAt(position);
+
+    // Only the layers between the old and new rod tips change
+    for (int layer = bank.insertedLayers; layer < layers; ++layer) {
+        for (int column : bank.columns) {
+            int cell = column * zSize + (zSize - 1 - layer);
+            if (elements[cell].getMaterial() == MaterialType::Fuel) {
+                setCellMaterial(cell, MaterialType::ControlRod);
             }
         }
     }
+    for (int layer = bank.insertedLayers - 1; layer >= layers; --layer) {
+        for (int column : bank.columns) {
+            int cell = column * zSize + (zSize - 1 - layer);
+            if (elements[cell].getMaterial() == MaterialType::ControlRod) {
+                setCellMaterial(cell, MaterialType::Fuel);
+            }
+        }
+    }
+    bank.insertedLayers = layers;
+}
+
+void Core::setCellMaterial(int cell, MaterialType material) {
+    CoreElement& element = elements[cell];
+    MaterialType previous = element.getMaterial();
+    element.setMaterial(material);
+    ++materialRevision;
+
+    if (!activeCellsValid) {
+        return;
+    }
+
+    // The lists are patched in bulk before their next use (a rod tip moving a layer changes
+    // many cells)
+    changedCells.push_back(cell);
+
+    int x = cell / (ySize * zSize);
+    int y = (cell / zSize) % ySize;
+    int z = cell % zSize;
+    bool interior = x > 0 && x < xSize - 1 && y > 0 && y < ySize - 1 && z > 0 && z < zSize - 1;
+    if (previous == MaterialType::Fuel && interior) {
+        staleFluxCells.push_back(cell);
+    }
+
+    // Fuel and rods are both reactive; only the neighbors' reactivity terms change
+    forEachNeighbor(x, y, z, [&](int nx, int ny, int nz) {
+        int slot = reactiveSlot[index(nx, ny, nz)];
+        if (slot >= 0) {
+            neighborReactivity[slot] = neighborReactivityAt(nx, ny, nz);
+        }
+    });
 }
 
 void Core::increaseReactivity(double delta) {
+    updateActiveCells();
+
     // Increase the reactivity of all fuel elements
+    for (int cell : fuelCells) {
+        CoreElement& element = elements[cell];
+        double newReactivity = element.getReactivity() + delta;
+        element.setReactivity(newReactivity);
+    }
+}
+
+void Core::setU235Loading(double concentration) {
     for (auto& element : elements) {
         if (element.getMaterial() == MaterialType::Fuel) {
-            double newReactivity = element.getReactivity() + delta;
-            element.setReactivity(newReactivity);
+            element.setU235Concentration(concentration);
+            element.setSigmaA0(CoreElement::calculateSigmaA0(concentration, element.getXe135Concentration()));
         }
     }
 }
 
 void Core::calculateMultiGroupNeutronFlux(double deltaTime) {
-    // Create copies of current fluxes for each group
-    std::vector<std::vector<double>> newFluxes(numEnergyGroups, std::vector<double>(elements.size(), 0.0));
+    updateActiveCells();
+
+    // Only interior fuel cells carry flux
+    const int fluxCount = static_cast<int>(fluxCells.size());
+    std::vector<std::vector<double>> newFluxes(numEnergyGroups, std::vector<double>(fluxCount, 0.0));
 
     // Spatial steps
     double dx = 1.0;
     double dy = 1.0;
     double dz = 1.0;
 
+    const int xStride = ySize * zSize;
+    const int yStride = zSize;
+
     // Loop over energy groups
     for (int g = 0; g < numEnergyGroups; ++g) {
         // Parameters for group g (define based on materials)
         double D_g = 1.0; // Diffusion coefficient for group g
 
-        // Loop over all grid points
-        for (int x = 1; x < xSize - 1; ++x) {
-            for (int y = 1; y < ySize - 1; ++y) {
-                for (int z = 1; z < zSize - 1; ++z) {
-                    int idx = index(x, y, z);
-                    CoreElement& element = elements[idx];
-
-                    if (element.getMaterial() == MaterialType::Fuel) {
-                        // Get neighboring fluxes for group g
-                        double phi_center = element.getNeutronFlux(g);
-                        double phi_x_plus = elements[index(x + 1, y, z)].getNeutronFlux(g);
-                        double phi_x_minus = elements[index(x - 1, y, z)].getNeutronFlux(g);
-                        double phi_y_plus = elements[index(x, y + 1, z)].getNeutronFlux(g);
-                        double phi_y_minus = elements[index(x, y - 1, z)].getNeutronFlux(g);
-                        double phi_z_plus = elements[index(x, y, z + 1)].getNeutronFlux(g);
-                        double phi_z_minus = elements[index(x, y, z - 1)].getNeutronFlux(g);
-
-                        // Laplacian for group g
-                        double laplacian = (phi_x_plus - 2 * phi_center + phi_x_minus) / (dx * dx)
-                                         + (phi_y_plus - 2 * phi_center + phi_y_minus) / (dy * dy)
-                                         + (phi_z_plus - 2 * phi_center + phi_z_minus) / (dz * dz);
-
-                        // Absorption term
-                        double Sigma_a_g = element.getSigmaA(g);
-                        double absorption = -Sigma_a_g * phi_center;
-
-                        // Scattering term
-                        double scattering = 0.0;
-                        for (int g_prime = 0; g_prime < numEnergyGroups; ++g_prime) {
-                            if (g_prime != g) {
-                                double Sigma_s_gp_to_g = element.getSigmaS(g_prime, g);
-                                double phi_gp = element.getNeutronFlux(g_prime);
-                                scattering += Sigma_s_gp_to_g * phi_gp;
-                            }
-                        }
+        // Loop over the interior fuel cells
+        for (int i = 0; i < fluxCount; ++i) {
+            int idx = fluxCells[i];
+            CoreElement& element = elements[idx];
+
+            // Get neighboring fluxes for group g
+            double phi_center = element.getNeutronFlux(g);
+            double phi_x_plus = elements[idx + xStride].getNeutronFlux(g);
+            double phi_x_minus = elements[idx - xStride].getNeutronFlux(g);
+            double phi_y_plus = elements[idx + yStride].getNeutronFlux(g);
+            double phi_y_minus = elements[idx - yStride].getNeutronFlux(g);
+            double phi_z_plus = elements[idx + 1].getNeutronFlux(g);
+            double phi_z_minus = elements[idx - 1].getNeutronFlux(g);
+
+            // Laplacian for group g
+            double laplacian = (phi_x_plus - 2 * phi_center + phi_x_minus) / (dx * dx)
+                             + (phi_y_plus - 2 * phi_center + phi_y_minus) / (dy * dy)
+                             + (phi_z_plus - 2 * phi_center + phi_z_minus) / (dz * dz);
+
+            // Absorption term
+            double Sigma_a_g = element.getSigmaA(g);
+            double absorption = -Sigma_a_g * phi_center;
+
+            // Scattering term
+            double scattering = 0.0;
+            for (int g_prime = 0; g_prime < numEnergyGroups; ++g_prime) {
+                if (g_prime != g) {
+                    double Sigma_s_gp_to_g = element.getSigmaS(g_prime, g);
+                    double phi_gp = element.getNeutronFlux(g_prime);
+                    scattering += Sigma_s_gp_to_g * phi_gp;
+                }
+            }
 
-                        // Fission source term
-                        double fission_source = 0.0;
-                        for (int g_prime = 0; g_prime < numEnergyGroups; ++g_prime) {
-                            double nuSigma_f_gp = element.getSigmaF(g_prime); // Assuming nu included
-                            double phi_gp = element.getNeutronFlux(g_prime);
-                            fission_source += element.getChi(g) * nuSigma_f_gp * phi_gp;
-                        }
+            // Fission source term
+            double fission_source = 0.0;
+            for (int g_prime = 0; g_prime < numEnergyGroups; ++g_prime) {
+                double nuSigma_f_gp = element.getSigmaF(g_prime); // Assuming nu included
+                double phi_gp = element.getNeutronFlux(g_prime);
+                fission_source += element.getChi(g) * nuSigma_f_gp * phi_gp;
+            }
 
-                        // Right-hand side for group g
-                        double rhs = D_g * laplacian + absorption + scattering + fission_source;
+            // Right-hand side for group g
+            double rhs = D_g * laplacian + absorption + scattering + fission_source;
 
-                        // Update flux
-                        newFluxes[g][idx] = phi_center + deltaTime * rhs;
-                    } else {
-                        newFluxes[g][idx] = 0.0;
-                    }
-                }
-            }
+            // Update flux
+            newFluxes[g][i] = phi_center + deltaTime * rhs;
         }
     }
 
     // Update fluxes for all groups
     for (int g = 0; g < numEnergyGroups; ++g) {
-        for (size_t i = 0; i < elements.size(); ++i) {
-            elements[i].setNeutronFlux(g, newFluxes[g][i]);
+        for (int i = 0; i < fluxCount; ++i) {
+            elements[fluxCells[i]].setNeutronFlux(g, newFluxes[g][i]);
+        }
+    }
+
+    // Cells that left the stencil keep their old flux until now, as neighbors read it above
+    for (int cell : staleFluxCells) {
+        if (std::binary_search(fluxCells.begin(), fluxCells.end(), cell)) {
+            continue; // Back in the stencil already (rod moved out again)
+        }
+        for (int g = 0; g < numEnergyGroups; ++g) {
+            elements[cell].setNeutronFlux(g, 0.0);
         }
     }
+    staleFluxCells.clear();
 }
 
-void Core::updateFuelBurnup(double delta_time) {
-    for (auto& element : elements) {
-        if (element.getMaterial() == MaterialType::Fuel) {
-            element.updateBurnup(delta_time);
+void Core::advanceBurnup(double deltaTime, double interval) {
+    updateActiveCells();
+
+    for (int cell : fuelCells) {
+        fluence[cell] += elements[cell].getNeutronFlux(0) * deltaTime;
+    }
+    burnupElapsed += deltaTime;
+
+    if (burnupElapsed >= interval) {
+        updateFuelBurnup();
+    }
+}
+
+void Core::updateFuelBurnup() {
+    // Cells that left the fuel during the interval (rod moves) still get the fluence they saw,
+    // and any iodine and xenon they hold keeps decaying
+    for (std::size_t cell = 0; cell < elements.size(); ++cell) {
+        CoreElement& element = elements[cell];
+        if (fluence[cell] != 0.0 || element.getI135Concentration() != 0.0 || element.getXe135Concentration() != 0.0) {
+            element.updateBurnup(fluence[cell], burnupElapsed);
+            fluence[cell] = 0.0;
         }
     }
+    burnupElapsed = 0.0;
 }
 
-std::vector<CoreElement*> Core::getNeighbors(int x, int y, int z) {
-    std::vector<CoreElement*> neighbors;
+int Core::advanceFluxAdaptive(double deltaTime, double tolerance, double& fluxStep) {
+    const double minFluxStep = 1e-5;
+    updateActiveCells();
+
+    if (fluxStep <= 0.0) {
+        fluxStep = deltaTime;
+    }
+
+    int substeps = 0;
+    double remaining = deltaTime;
+    while (remaining > 0.0) {
+        double h = std::max(std::min(fluxStep, remaining), std::min(minFluxStep, remaining));
+        bool truncated = h < fluxStep;
+
+        saveFlux(fluxStart);
+        calculateMultiGroupNeutronFlux(0.5 * h);
+        calculateMultiGroupNeutronFlux(0.5 * h);
+        saveFlux(fluxFine);
+
+        restoreFlux(fluxStart);
+        calculateMultiGroupNeutronFlux(h);
+
+        // Difference between the two solutions, relative to the peak flux
+        double difference = 0.0, scale = 0.0;
+        for (std::size_t k = 0; k < fluxFine.cells.size(); ++k) {
+            for (int g = 0; g < numEnergyGroups; ++g) {
+                double fine = fluxFine.flux[k * numEnergyGroups + g];
+                difference = std::max(difference, std::abs(fine - elements[fluxFine.cells[k]].getNeutronFlux(g)));
+                scale = std::max(scale, std::abs(fine));
+            }
+        }
+        double error = scale > 0.0 ? difference / (tolerance * scale) : 0.0;
+
+        // First-order method: the local error scales with h^2
+        double nextStep = h * std::clamp(0.9 / std::sqrt(std::max(error, 1e-12)), 0.2, 5.0);
+
+        if (error <= 1.0 || h <= minFluxStep) {
+            restoreFlux(fluxFine);
+            remaining -= h;
+            ++substeps;
+            // A step cut short by the end of the interval says nothing against a longer one
+            fluxStep = truncated ? std::max(fluxStep, nextStep) : nextStep;
+        } else {
+            restoreFlux(fluxStart);
+            fluxStep = nextStep;
+        }
+    }
+    return substeps;
+}
 
-    const int dx[] = { -1, 1, 0, 0, 0, 0 };
-    const int dy[] = { 0, 0, -1, 1, 0, 0 };
-    const int dz[] = { 0, 0, 0, 0, -1, 1 };
+void Core::saveFlux(FluxSnapshot& snapshot) const {
+    snapshot.cells = fluxCells;
+    snapshot.cells.insert(snapshot.cells.end(), staleFluxCells.begin(), staleFluxCells.end());
+    snapshot.staleCells = staleFluxCells;
+    snapshot.flux.resize(snapshot.cells.size() * numEnergyGroups);
+    for (std::size_t k = 0; k < snapshot.cells.size(); ++k) {
+        for (int g = 0; g < numEnergyGroups; ++g) {
+            snapshot.flux[k * numEnergyGroups + g] = elements[snapshot.cells[k]].getNeutronFlux(g);
+        }
+    }
+}
 
-    for (int i = 0; i < 6; ++i) {
-        int nx = x + dx[i];
-        int ny = y + dy[i];
-        int nz = z + dz[i];
+void Core::restoreFlux(const FluxSnapshot& snapshot) {
+    for (std::size_t k = 0; k < snapshot.cells.size(); ++k) {
+        for (int g = 0; g < numEnergyGroups; ++g) {
+            elements[snapshot.cells[k]].setNeutronFlux(g, snapshot.flux[k * numEnergyGroups + g]);
+        }
+    }
+    staleFluxCells = snapshot.staleCells;
+}
+
+const std::vector<int>& Core::getFuelCells() {
+    updateActiveCells();
+    return fuelCells;
+}
+
+void Core::invalidateActiveCells() {
+    activeCellsValid = false;
+    ++materialRevision;
+}
 
-        if (nx >= 0 && nx < xSize && ny >= 0 && ny < ySize && nz >= 0 && nz < zSize) {
-            neighbors.push_back(&elements[index(nx, ny, nz)]);
+void Core::updateActiveCells() {
+    if (activeCellsValid) {
+        if (!changedCells.empty()) {
+            patchActiveCells();
         }
+        return;
     }
+    activeCellsValid = true;
 
+    changedCells.clear();
+    fuelCells.clear();
+    fluxCells.clear();
+    staleFluxCells.clear();
+    reactiveCells.clear();
+    neighborReactivity.clear();
+    reactiveSlot.assign(elements.size(), -1);
+
+    for (int x = 0; x < xSize; ++x) {
+        for (int y = 0; y < ySize; ++y) {
+            for (int z = 0; z < zSize; ++z) {
+                int idx = index(x, y, z);
+                CoreElement& element = elements[idx];
+                MaterialType material = element.getMaterial();
+
+                if (material != MaterialType::Vessel) {
+                    reactiveSlot[idx] = static_cast<int>(reactiveCells.size());
+                    reactiveCells.push_back(idx);
+                    neighborReactivity.push_back(neighborReactivityAt(x, y, z));
+                }
+                if (material == MaterialType::Fuel) {
+                    fuelCells.push_back(idx);
+                }
+
+                bool interior = x > 0 && x < xSize - 1 && y > 0 && y < ySize - 1 && z > 0 && z < zSize - 1;
+                if (interior && material == MaterialType::Fuel) {
+                    fluxCells.push_back(idx);
+                } else {
+                    for (int g = 0; g < numEnergyGroups; ++g) {
+                        if (element.getNeutronFlux(g) != 0.0) {
+                            staleFluxCells.push_back(idx);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void Core::patchActiveCells() {
+    // One merge pass over each list against the changed cells (sorted), keeping the lists in
+    // ascending cell order: reductions over them (heat exchange) then sum in the same order as
+    // after a full rebuild and rewinds replay bit-identically
+    std::sort(changedCells.begin(), changedCells.end());
+    changedCells.erase(std::unique(changedCells.begin(), changedCells.end()), changedCells.end());
+
+    auto patch = [&](std::vector<int>& list, auto belongs) {
+        patchedCells.clear();
+        patchedCells.reserve(list.size() + changedCells.size());
+        auto changed = changedCells.begin();
+        for (int cell : list) {
+            for (; changed != changedCells.end() && *changed < cell; ++changed) {
+                if (belongs(*changed)) {
+                    patchedCells.push_back(*changed);
+                }
+            }
+            if (changed != changedCells.end() && *changed == cell) {
+                ++changed;
+                if (!belongs(cell)) {
+                    continue;
+                }
+            }
+            patchedCells.push_back(cell);
+        }
+        for (; changed != changedCells.end(); ++changed) {
+            if (belongs(*changed)) {
+                patchedCells.push_back(*changed);
+            }
+        }
+        list.swap(patchedCells);
+    };
+
+    auto isFuel = [&](int cell) { return elements[cell].getMaterial() == MaterialType::Fuel; };
+    patch(fuelCells, isFuel);
+    patch(fluxCells, [&](int cell) {
+        int x = cell / (ySize * zSize);
+        int y = (cell / zSize) % ySize;
+        int z = cell % zSize;
+        return isFuel(cell) && x > 0 && x < xSize - 1 && y > 0 && y < ySize - 1 && z > 0 && z < zSize - 1;
+    });
+    changedCells.clear();
+}
+
+std::size_t Core::getStateSize() const {
+    return rodBankStateSize * rodBanks.size() + elements.size() * CoreElement::stateSize + 1 + fluence.size()
+         + PointKinetics::stateSize;
+}
+
+void Core::captureState(std::vector<double>& state) const {
+    std::size_t offset = state.size();
+    state.resize(offset + getStateSize());
+
+    double* out = state.data() + offset;
+    for (const auto& bank : rodBanks) {
+        *out++ = bank.position;
+        *out++ = bank.target;
+        *out++ = bank.velocity;
+        *out++ = bank.tripTime;
+    }
+    for (const auto& element : elements) {
+        element.writeState(out);
+        out += CoreElement::stateSize;
+    }
+    *out++ = burnupElapsed;
+    out = std::copy(fluence.begin(), fluence.end(), out);
+    pointKinetics.writeState(out);
+}
+
+bool Core::restoreState(const double* state, std::size_t size) {
+    if (size != getStateSize()) {
+        return false;
+    }
+
+    for (auto& bank : rodBanks) {
+        bank.position = *state++;
+        bank.target = *state++;
+        bank.velocity = *state++;
+        bank.tripTime = *state++;
+        bank.insertedLayers = layersAt(bank.position);
+    }
+    for (auto& element : elements) {
+        element.readState(state);
+        state += CoreElement::stateSize;
+    }
+    burnupElapsed = *state++;
+    std::copy(state, state + fluence.size(), fluence.begin());
+    state += fluence.size();
+    pointKinetics.readState(state);
+    invalidateActiveCells();
+    return true;
+}
+
+std::vector<CoreElement*> Core::getNeighbors(int x, int y, int z) {
+    std::vector<CoreElement*> neighbors;
+    forEachNeighbor(x, y, z, [&](int nx, int ny, int nz) { neighbors.push_back(&elements[index(nx, ny, nz)]); });
     return neighbors;
+}
+
+double Core::neighborReactivityAt(int x, int y, int z) const {
+    // Same terms and order as CoreElement::calculateNeighborReactivity(getNeighbors(x, y, z))
+    double reactivityEffect = 0.0;
+    forEachNeighbor(x, y, z, [&](int nx, int ny, int nz) {
+        reactivityEffect += CoreElement::getNeighborReactivity(elements[index(nx, ny, nz)].getMaterial());
+    });
+    return reactivityEffect;
 }
\ No newline at end of file
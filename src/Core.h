@@ -4,9 +4,33 @@
 
 #ifndef CORE_H
 #define CORE_H
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
 #include <vector>
 
 #include "CoreElement.h"
+#include "PointKinetics.h"
+
+// A group of rod columns driven together from the top of the core
+struct RodBank {
+    std::vector<int> columns;   // x * ySize + y of each rod column
+    double position = 0.0;      // Inserted fraction of the core height (0 = fully withdrawn)
+    double target = 0.0;        // Position the drive is moving towards
+    double speed = 0.1;         // Fraction of full stroke per second; <= 0 moves instantly
+    int insertedLayers = 0;     // Top layers of the columns currently holding rod material
+    double velocity = 0.0;      // Drop velocity after a trip, fraction per second
+    double tripTime = -1.0;     // Seconds since the bank was tripped, or -1 if latched to its drive
+};
+
+// Rod-drop curve after a trip: the banks unlatch after a delay, then fall with constant
+// acceleration up to a terminal velocity
+struct ScramProfile {
+    double delay = 0.15;        // s from trip to the start of motion
+    double acceleration = 4.0;  // Fraction of full stroke per s^2
+    double maxVelocity = 0.8;   // Fraction of full stroke per s
+};
 
 class Core {
 public:
@@ -14,8 +38,26 @@ public:
 
     void initializeCore();
     void calculateCoreThermals(double deltaTime);
+
+    // A fuel cell's population grows by (1 + reactivity) every populationStepTime, so the
+    // change over a step follows its length (the nominal step keeps the per-step factor)
+    static constexpr double populationStepTime = 0.033; // s
+    static double populationGrowth(double reactivity, double deltaTime) {
+        const double factor = std::max(0.0, 1.0 + reactivity);
+        const double steps = deltaTime / populationStepTime;
+        return steps == 1.0 ? factor : std::pow(factor, steps); // pow(x, 1) is x exactly
+    }
     void updateNeutronPopulation();
-    void insertControlRods();
+
+    // Trips every bank; the rods then drop over the next moveControlRods calls following the
+    // scram profile. Tripped banks ignore drive targets until the core is reinitialized.
+    void scram();
+    [[nodiscard]] bool isScrammed() const;
+    [[nodiscard]] bool isScramComplete() const; // Every tripped bank fully inserted
+    [[nodiscard]] double getTimeSinceScram() const;
+    [[nodiscard]] bool areRodsMoving() const; // Any bank away from its target or still dropping
+    void setScramProfile(const ScramProfile& profile) { scramProfile = profile; }
+    [[nodiscard]] const ScramProfile& getScramProfile() const { return scramProfile; }
 
     // Getters
     [[nodiscard]] const std::vector<CoreElement>& getElements() const { return elements; }
@@ -29,26 +71,144 @@ public:
     [[nodiscard]] int getYSize() const { return ySize; }
     [[nodiscard]] int getZSize() const { return zSize; }
 
-    void setControlRodInsertion(double insertion_depth);
+    // Rod banks move toward their targets at their drive speed in moveControlRods; only the
+    // cells a rod tip passes change material
+    bool setControlRodInsertion(double insertion_depth); // Target for every bank
+    bool setBankInsertion(int bank, double insertionDepth);
+    void setRodSpeed(double fractionPerSecond);
+    void moveControlRods(double deltaTime);
+    [[nodiscard]] int getBankCount() const { return static_cast<int>(rodBanks.size()); }
+    [[nodiscard]] const RodBank& getBank(int bank) const { return rodBanks[bank]; }
 
     void increaseReactivity(double delta);
 
-    double getControlRodInsertion() const { return controlRodInsertion; }
+    // Reactivity change per kelvin above the 300 K nominal temperature (negative feedback)
+    void setTemperatureCoefficient(double coefficient) { temperatureCoefficient = coefficient; }
+    [[nodiscard]] double getTemperatureCoefficient() const { return temperatureCoefficient; }
+
+    // Reactivity change per unit coolant void fraction in the cell's channel (negative feedback)
+    void setVoidCoefficient(double coefficient) { voidCoefficient = coefficient; }
+    [[nodiscard]] double getVoidCoefficient() const { return voidCoefficient; }
+
+    // Sets the U-235 concentration of every fuel element and updates its absorption cross-section
+    void setU235Loading(double concentration);
+
+    // Mean actual position of the rod banks, 0.0 to 1.0
+    [[nodiscard]] double getControlRodInsertion() const;
 
     std::mutex& getMutex() const { return coreMutex; }
 
+    // Bumped whenever element materials or cross-sections may have changed
+    [[nodiscard]] std::uint64_t getMaterialRevision() const { return materialRevision; }
+
     void calculateMultiGroupNeutronFlux(double deltaTime);
 
-    void updateFuelBurnup(double delta_time);
+    // Point-kinetics alternative to the flux and thermal kernels: total power follows the
+    // point-reactor equations for the power-weighted mean of the cells' reactivity, and is
+    // spread over the fuel with the flux shape cached at the last material change. Element
+    // reactivities are not updated in this mode.
+    void calculatePointKinetics(double deltaTime);
+    [[nodiscard]] const PointKinetics& getPointKinetics() const { return pointKinetics; }
+    void setPointKineticsParameters(const PointKineticsParameters& parameters) {
+        pointKinetics.setParameters(parameters);
+    }
+
+    // Advances the flux by deltaTime in error-controlled substeps. Each substep is checked by
+    // step doubling (one step of h against two of h/2) and the two-half-step solution kept;
+    // fluxStep carries the controller's step size from call to call. Returns the substeps taken.
+    int advanceFluxAdaptive(double deltaTime, double tolerance, double& fluxStep);
+
+    // Burnup is a slow process: every step only integrates the group-0 flux of each cell, and
+    // the depletion and iodine-xenon chain run once the accumulated time reaches interval
+    // (0 = every step), over the whole accumulated time at its mean flux
+    void advanceBurnup(double deltaTime, double interval);
+    void updateFuelBurnup(); // Applies and clears the accumulated fluence
+
+    // Indices of the fuel cells; the hot loops iterate these instead of the whole box
+    const std::vector<int>& getFuelCells();
+
+    // Session history snapshots (appended to / read from a flat buffer)
+    [[nodiscard]] std::size_t getStateSize() const;
+    void captureState(std::vector<double>& state) const;
+    bool restoreState(const double* state, std::size_t size);
 
 private:
-    int xSize, ySize, zSize, numEnergyGroups;
+    int xSize, ySize, zSize;
     std::vector<CoreElement> elements;
-    double controlRodInsertion; // 0.0 to 1.0
+    std::vector<RodBank> rodBanks;
+    ScramProfile scramProfile;
+    std::uint64_t materialRevision;
+    double temperatureCoefficient;
+    double voidCoefficient;
+    std::vector<double> fluence; // Group-0 flux integrated since the last burnup update, per cell
+    double burnupElapsed;        // Time covered by fluence
+    PointKinetics pointKinetics;
+    std::vector<double> powerShape; // Fraction of the power in fuelCells[i]
+    std::uint64_t shapeRevision;    // Material revision powerShape was built for
+    double shapeNeighborReactivity; // Power-weighted neighbor reactivity of the fuel
     mutable std::mutex coreMutex;
 
+    // Active-cell lists. Rod motion records the cells it changes and the next updateActiveCells
+    // patches the lists in one merge pass; other material changes (initialization, scram,
+    // restores) invalidate them for a full rebuild.
+    bool activeCellsValid;
+    std::vector<int> changedCells;            // Material changed since the lists were patched
+    std::vector<int> patchedCells;            // Scratch for patchActiveCells
+    std::vector<int> fuelCells;               // Fuel anywhere (burnup, thermals, heat exchange)
+    std::vector<int> fluxCells;               // Interior fuel (flux stencil)
+    std::vector<int> staleFluxCells;          // Outside the stencil but still holding flux
+    std::vector<int> reactiveCells;           // Any non-vessel cell (reactivity)
+    std::vector<double> neighborReactivity;   // Neighbor term of reactiveCells[i]
+    std::vector<int> reactiveSlot;            // Position of each cell in reactiveCells, or -1
+
     // Helper functions
     std::vector<CoreElement*> getNeighbors(int x, int y, int z);
+    double neighborReactivityAt(int x, int y, int z) const;
+    void updateActiveCells();
+    void patchActiveCells();
+    void invalidateActiveCells();
+    void setCellMaterial(int cell, MaterialType material);
+
+    // Calls visit(nx, ny, nz) for each face neighbor in getNeighbors order, without allocating
+    template <typename Visit>
+    void forEachNeighbor(int x, int y, int z, Visit visit) const {
+        if (x > 0) {
+            visit(x - 1, y, z);
+        }
+        if (x < xSize - 1) {
+            visit(x + 1, y, z);
+        }
+        if (y > 0) {
+            visit(x, y - 1, z);
+        }
+        if (y < ySize - 1) {
+            visit(x, y + 1, z);
+        }
+        if (z > 0) {
+            visit(x, y, z - 1);
+        }
+        if (z < zSize - 1) {
+            visit(x, y, z + 1);
+        }
+    }
+
+    void initializeRodBanks();
+    void updatePowerShape();
+    void moveBank(RodBank& bank, double position);
+    void dropBank(RodBank& bank, double deltaTime);
+
+    // Flux of the stencil (and stale) cells, for retrying a flux step
+    struct FluxSnapshot {
+        std::vector<int> cells;
+        std::vector<int> staleCells;
+        std::vector<double> flux; // [cell][group]
+    };
+    void saveFlux(FluxSnapshot& snapshot) const;
+    void restoreFlux(const FluxSnapshot& snapshot);
+    FluxSnapshot fluxStart, fluxFine;
+    [[nodiscard]] int layersAt(double position) const;
+
+    static constexpr std::size_t rodBankStateSize = 4; // position, target, velocity, tripTime
 
 };
 
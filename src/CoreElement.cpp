@@ -4,21 +4,28 @@
 
 #include "CoreElement.h"
 #include "Constants.h"
+#include <cmath>
 
 const double sigma_a_U235 = 680.0;   // Example microscopic cross-section value in barns
 const double sigma_a_Xe135 = 2.65e6; // Example value in barns
 
+// Iodine-xenon chain
+const double yield_I135 = 0.0639;    // Cumulative fission yield of I-135
+const double yield_Xe135 = 0.00237;  // Direct fission yield of Xe-135
+const double lambda_I135 = 2.87e-5;  // Decay constant (1/s), 6.7 h half-life
+const double lambda_Xe135 = 2.09e-5; // Decay constant (1/s), 9.2 h half-life
+const double fluxScale = 3.0e13;     // n/(cm^2 s) per unit of model flux (full power)
+const double barn = 1.0e-24;         // cm^2
+
 // Assuming numEnergyGroups is defined somewhere globally or accessible
 
 CoreElement::CoreElement()
-    : material(MaterialType::Vessel), temperature(300.0), reactivity(0.0), neutronPopulation(0.0) {
-    // Initialize vectors with the correct size
+    : material(MaterialType::Vessel), temperature(300.0), reactivity(0.0), neutronPopulation(0.0), coolantVoid(0.0) {
     initializeVectors();
 }
 
 CoreElement::CoreElement(MaterialType material, double temperature)
-    : material(material), temperature(temperature), reactivity(0.0), neutronPopulation(0.0) {
-    // Initialize vectors with the correct size
+    : material(material), temperature(temperature), reactivity(0.0), neutronPopulation(0.0), coolantVoid(0.0) {
     initializeVectors();
 
     // Initialize neutron population and neutron flux based on material type
@@ -48,12 +55,14 @@ CoreElement::CoreElement(MaterialType material, double temperature)
 }
 
 void CoreElement::initializeVectors() {
-    // Initialize vectors with the correct size
-    neutronFlux.resize(numEnergyGroups, 0.0);
-    Sigma_a.resize(numEnergyGroups, 0.0);
-    Sigma_f.resize(numEnergyGroups, 0.0);
-    Chi.resize(numEnergyGroups, 0.0);
-    Sigma_s.resize(numEnergyGroups, std::vector<double>(numEnergyGroups, 0.0));
+    // Per-group arrays are fixed size; start them at zero
+    neutronFlux.fill(0.0);
+    Sigma_a.fill(0.0);
+    Sigma_f.fill(0.0);
+    Chi.fill(0.0);
+    for (auto& row : Sigma_s) {
+        row.fill(0.0);
+    }
 }
 
 MaterialType CoreElement::getMaterial() const {
@@ -83,33 +92,61 @@ void CoreElement::setNeutronPopulation(double neutronPopulation) {
     this->neutronPopulation = neutronPopulation;
 }
 
+double CoreElement::getCoolantVoid() const {
+    return coolantVoid;
+}
+
+void CoreElement::setCoolantVoid(double voidFraction) {
+    coolantVoid = voidFraction;
+}
+
 // Methods
 
-void CoreElement::calculateReactivity(const std::vector<CoreElement*>& neighbors) {
+void CoreElement::calculateReactivity(const std::vector<CoreElement*>& neighbors, double temperatureCoefficient,
+                                      double voidCoefficient) {
+    applyReactivity(calculateNeighborReactivity(neighbors), temperatureCoefficient, voidCoefficient);
+}
+
+double CoreElement::calculateNeighborReactivity(const std::vector<CoreElement*>& neighbors) {
     // Simplified reactivity calculation based on neighboring elements
 
     double reactivityEffect = 0.0;
 
     for (const auto& neighbor : neighbors) {
-        if (neighbor->getMaterial() == MaterialType::Fuel) {
-            reactivityEffect += 0.01; // positive reactivity from adjacent fuel
-        } else if (neighbor->getMaterial() == MaterialType::ControlRod) {
-            reactivityEffect -= 0.02; // negative reactivity from adjacent control rod
-        }
-        // Vessel material does not affect reactivity
+        reactivityEffect += getNeighborReactivity(neighbor->getMaterial());
+    }
+    return reactivityEffect;
+}
+
+double CoreElement::getNeighborReactivity(MaterialType material) {
+    if (material == MaterialType::Fuel) {
+        return 0.01; // positive reactivity from adjacent fuel
     }
+    if (material == MaterialType::ControlRod) {
+        return -0.02; // negative reactivity from adjacent control rod
+    }
+    return 0.0; // Vessel material does not affect reactivity
+}
 
+void CoreElement::applyReactivity(double neighborReactivity, double temperatureCoefficient, double voidCoefficient) {
     // Tempeerature feedback (negative reactivity coefficient)
-    double temperatureCoefficient = -0.0001; // Negative because higher temp reduces reactivity
     double temperatureReactivity = temperatureCoefficient * (temperature - 300.0); // 300K is nominal temperature
 
-    // Total reactiivty is the sum of neigbhor effects and temperature feedback
-    reactivity = reactivityEffect + temperatureReactivity;
+    // Void feedback: steam in the channel moderates less (negative coefficient)
+    double voidReactivity = voidCoefficient * coolantVoid;
+
+    // Total reactiivty is the sum of neigbhor effects, temperature and void feedback
+    reactivity = neighborReactivity + temperatureReactivity + voidReactivity;
 }
 
 void CoreElement::updateTemperature(double heatInput, double deltaTime) {
     // Update temperature based on heat input, material properties, and deltaTime
+    // Temperature change: ΔT = (Q * deltaTime) / (m * c)
+    double deltaT = (heatInput * deltaTime) / getHeatCapacity();
+    temperature += deltaT;
+}
 
+double CoreElement::getHeatCapacity() const {
     // Simplified specific heat capacities (J/kg*K)
     double specificHeatCapacity = 0.0;
     double mass = 1.0; // Assume unit mass for simplicity
@@ -129,9 +166,21 @@ void CoreElement::updateTemperature(double heatInput, double deltaTime) {
         break;
     }
 
-    // Temperature change: ΔT = (Q * deltaTime) / (m * c)
-    double deltaT = (heatInput * deltaTime) / (mass * specificHeatCapacity);
-    temperature += deltaT;
+    return mass * specificHeatCapacity;
+}
+
+double CoreElement::getThermalConductivity() const {
+    // Uranium dioxide, boron carbide and stainless steel near operating temperature
+    switch (material) {
+        case MaterialType::Fuel:
+            return 3.0;
+        case MaterialType::ControlRod:
+            return 20.0;
+        case MaterialType::Vessel:
+            return 16.0;
+        default:
+            return 10.0;
+    }
 }
 
 void CoreElement::setMaterial(MaterialType material) {
@@ -142,6 +191,7 @@ void CoreElement::setMaterial(MaterialType material) {
         neutronPopulation = 1.0;
     } else {
         neutronPopulation = 0.0;
+        coolantVoid = 0.0; // No channel beside it any more
     }
 }
 
@@ -179,20 +229,39 @@ double CoreElement::getSigmaA() const {
     return Sigma_a_0 * sqrt(T0 / T);   // Negative temperature coefficient
 }
 
-void CoreElement::updateBurnup(double deltaTime) {
+void CoreElement::updateBurnup(double fluence, double interval) {
+    if (interval <= 0.0) {
+        return;
+    }
+
     int group = 0; // Assuming we're using group 0 for burnup calculations
-    double phi = this->getNeutronFlux(group);
     double Sigma_f = this->getSigmaF(group); // Fission cross-section
-    double fissionRate = Sigma_f * phi;
-
-    // Constants
-    double yield_Xe135 = 0.065; // Example value
+    double fissions = Sigma_f * fluence;     // Fission rate integrated over the interval
+    double fissionRate = fissions / interval; // At the interval's mean flux
 
     // Deplete U-235
-    U235_concentration -= fissionRate * deltaTime;
+    U235_concentration -= fissions;
+
+    // Iodine relaxes towards its equilibrium with the fission rate
+    double decayI = std::exp(-lambda_I135 * interval);
+    double iodineEquilibrium = yield_I135 * fissionRate / lambda_I135;
+    double iodineExcess = I135_concentration - iodineEquilibrium;
 
-    // Build up Xe-135
-    Xe135_concentration += fissionRate * deltaTime * yield_Xe135;
+    // Xenon is lost by decay and by burnout (neutron capture) at the mean flux, and fed by
+    // fission and by the iodine decay
+    double meanFlux = fluence / interval;
+    double removalXe = lambda_Xe135 + sigma_a_Xe135 * barn * fluxScale * meanFlux;
+    double decayXe = std::exp(-removalXe * interval);
+    double xenonEquilibrium = (yield_Xe135 + yield_I135) * fissionRate / removalXe;
+
+    // The iodine excess feeds xenon as lambda_I * excess * exp(-lambda_I t); its integral
+    // against the xenon removal, written to stay exact when the two rates coincide
+    double rateGap = removalXe - lambda_I135;
+    double overlap = rateGap != 0.0 ? -std::expm1(-rateGap * interval) / rateGap : interval;
+    double fromIodine = lambda_I135 * iodineExcess * decayI * overlap;
+
+    Xe135_concentration = xenonEquilibrium + (Xe135_concentration - xenonEquilibrium) * decayXe + fromIodine;
+    I135_concentration = iodineEquilibrium + iodineExcess * decayI;
 
     // Update cross-sections based on new concentrations
     // For example:
@@ -207,6 +276,14 @@ void CoreElement::setU235Concentration(double conc) {
     U235_concentration = conc;
 }
 
+double CoreElement::getI135Concentration() const {
+    return I135_concentration;
+}
+
+void CoreElement::setI135Concentration(double conc) {
+    I135_concentration = conc;
+}
+
 double CoreElement::getXe135Concentration() const {
     return Xe135_concentration;
 }
@@ -215,6 +292,14 @@ void CoreElement::setXe135Concentration(double conc) {
     Xe135_concentration = conc;
 }
 
+double CoreElement::getSigmaA0() const {
+    return Sigma_a_0;
+}
+
+void CoreElement::setSigmaA0(double sigmaA0) {
+    Sigma_a_0 = sigmaA0;
+}
+
 // Function to calculate base absorption cross-section
 double CoreElement::calculateSigmaA0(double U235_conc, double Xe135_conc) {
     // Example calculation using macroscopic cross-section formula
@@ -226,4 +311,48 @@ double CoreElement::calculateSigmaA0(double U235_conc, double Xe135_conc) {
 
 double CoreElement::getSigmaS(int fromGroup, int toGroup) const {
     return Sigma_s[fromGroup][toGroup];
+}
+
+void CoreElement::writeState(double* out) const {
+    *out++ = static_cast<double>(material);
+    *out++ = temperature;
+    *out++ = reactivity;
+    *out++ = neutronPopulation;
+    *out++ = coolantVoid;
+    *out++ = Sigma_a_0;
+    *out++ = U235_concentration;
+    *out++ = I135_concentration;
+    *out++ = Xe135_concentration;
+
+    for (int g = 0; g < numEnergyGroups; ++g) {
+        *out++ = neutronFlux[g];
+        *out++ = Sigma_a[g];
+        *out++ = Sigma_f[g];
+        *out++ = Chi[g];
+        for (int gp = 0; gp < numEnergyGroups; ++gp) {
+            *out++ = Sigma_s[g][gp];
+        }
+    }
+}
+
+void CoreElement::readState(const double* in) {
+    material = static_cast<MaterialType>(static_cast<int>(*in++));
+    temperature = *in++;
+    reactivity = *in++;
+    neutronPopulation = *in++;
+    coolantVoid = *in++;
+    Sigma_a_0 = *in++;
+    U235_concentration = *in++;
+    I135_concentration = *in++;
+    Xe135_concentration = *in++;
+
+    for (int g = 0; g < numEnergyGroups; ++g) {
+        neutronFlux[g] = *in++;
+        Sigma_a[g] = *in++;
+        Sigma_f[g] = *in++;
+        Chi[g] = *in++;
+        for (int gp = 0; gp < numEnergyGroups; ++gp) {
+            Sigma_s[g][gp] = *in++;
+        }
+    }
 }
\ No newline at end of file
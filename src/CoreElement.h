@@ -4,8 +4,12 @@
 
 #ifndef COREELEMENT_H
 #define COREELEMENT_H
+#include <array>
 #include <vector>
 
+#include "Constants.h"
+#include "Precision.h"
+
 enum class MaterialType {
     Vessel,
     Fuel,
@@ -31,9 +35,21 @@ public:
     [[nodiscard]] double getNeutronPopulation() const;
     void setNeutronPopulation(double neutronPopulation);
 
+    // Void fraction of the coolant channel beside the cell (0 = all liquid), set by the
+    // coolant channels each step; only fuel cells sit in a channel
+    [[nodiscard]] double getCoolantVoid() const;
+    void setCoolantVoid(double voidFraction);
+
     // Methods
-    void calculateReactivity(const std::vector<CoreElement*>& neighbors);
+    void calculateReactivity(const std::vector<CoreElement*>& neighbors, double temperatureCoefficient,
+                             double voidCoefficient = 0.0);
+    // The two parts of calculateReactivity: the neighbor term only changes with materials
+    static double calculateNeighborReactivity(const std::vector<CoreElement*>& neighbors);
+    static double getNeighborReactivity(MaterialType material); // One neighbor's term
+    void applyReactivity(double neighborReactivity, double temperatureCoefficient, double voidCoefficient = 0.0);
     void updateTemperature(double heatInput, double deltaTime);
+    [[nodiscard]] double getHeatCapacity() const; // Of the whole element, J/K
+    [[nodiscard]] double getThermalConductivity() const; // Of its material, W/(m K)
 
     void setMaterial(MaterialType material);
 
@@ -51,35 +67,78 @@ public:
     [[nodiscard]] double getChi(int group) const;
     [[nodiscard]] double getSigmaA() const;
 
-    void updateBurnup(double deltaTime);
+    // Depletes U-235 and advances the I-135 -> Xe-135 chain over interval seconds, for the
+    // group-0 fluence (flux integrated over time) received in that interval. The chain is
+    // integrated exactly at the interval's mean flux:
+    //
+    //   dI/dt  = yI Sf phi - lI I
+    //   dXe/dt = yXe Sf phi + lI I - (lXe + sXe phi) Xe
+    void updateBurnup(double fluence, double interval);
 
     // Getters and setters for concentrations
     [[nodiscard]] double getU235Concentration() const;
     void setU235Concentration(double conc);
 
+    [[nodiscard]] double getI135Concentration() const;
+    void setI135Concentration(double conc);
+
     [[nodiscard]] double getXe135Concentration() const;
     void setXe135Concentration(double conc);
 
+    [[nodiscard]] double getSigmaA0() const;
+    void setSigmaA0(double sigmaA0);
+
     static double calculateSigmaA0(double U235_conc, double Xe135_conc);
 
     [[nodiscard]] double getSigmaS(int fromGroup, int toGroup) const;
 
+    // Flat state used for session history snapshots and batched stepping. Layout:
+    // [material, temperature, reactivity, neutronPopulation, coolantVoid, Sigma_a_0, U235, I135, Xe135,
+    //  then per group g: flux, Sigma_a, Sigma_f, Chi, Sigma_s[g][0..numEnergyGroups)]
+    enum StateField {
+        StateMaterial,
+        StateTemperature,
+        StateReactivity,
+        StateNeutronPopulation,
+        StateCoolantVoid,
+        StateSigmaA0,
+        StateU235Concentration,
+        StateI135Concentration,
+        StateXe135Concentration,
+        StateGroupBase
+    };
+    static constexpr int stateGroupStride = 4 + numEnergyGroups;
+    static constexpr int stateFluxField(int g) { return StateGroupBase + g * stateGroupStride; }
+    static constexpr int stateSigmaAField(int g) { return stateFluxField(g) + 1; }
+    static constexpr int stateSigmaFField(int g) { return stateFluxField(g) + 2; }
+    static constexpr int stateChiField(int g) { return stateFluxField(g) + 3; }
+    static constexpr int stateSigmaSField(int from, int to) { return stateFluxField(from) + 4 + to; }
+    // Fields stored as AccumReal rather than FieldReal
+    static constexpr bool isAccumulatorField(int f) { return f >= StateSigmaA0 && f <= StateXe135Concentration; }
+
+    static constexpr int stateSize = 9 + 4 * numEnergyGroups + numEnergyGroups * numEnergyGroups;
+    void writeState(double* out) const;
+    void readState(const double* in);
+
 private:
     MaterialType material;
-    double temperature;
-    double reactivity;
-    double neutronPopulation;
-    double Sigma_a_0{};
-
-    double U235_concentration{};   // U-235 concentration
-    double Xe135_concentration{};  // Xe-135 concentration (neutron poison)
+    FieldReal temperature;
+    FieldReal reactivity;
+    FieldReal neutronPopulation;
+    FieldReal coolantVoid;
+    AccumReal Sigma_a_0{};
+
+    AccumReal U235_concentration{};   // U-235 concentration
+    AccumReal I135_concentration{};   // I-135 concentration (decays to Xe-135)
+    AccumReal Xe135_concentration{};  // Xe-135 concentration (neutron poison)
     // Other isotopes as needed
 
-    std::vector<double> neutronFlux;          // Neutron flux for each energy group
-    std::vector<double> Sigma_a;              // Absorption cross-section per group
-    std::vector<double> Sigma_f;              // Fission cross-section per group
-    std::vector<double> Chi;                  // Fission spectrum per group
-    std::vector<std::vector<double>> Sigma_s; // Scattering cross-section matrix
+    // Fixed-size per-group data lives inline, so a Core's elements are one contiguous block
+    std::array<FieldReal, numEnergyGroups> neutronFlux{}; // Neutron flux for each energy group
+    std::array<FieldReal, numEnergyGroups> Sigma_a{};     // Absorption cross-section per group
+    std::array<FieldReal, numEnergyGroups> Sigma_f{};     // Fission cross-section per group
+    std::array<FieldReal, numEnergyGroups> Chi{};         // Fission spectrum per group
+    std::array<std::array<FieldReal, numEnergyGroups>, numEnergyGroups> Sigma_s{}; // Scattering matrix
 
 };
 
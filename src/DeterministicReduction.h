@@ -0,0 +1,82 @@
+// DeterministicReduction.h
+
+#ifndef DETERMINISTICREDUCTION_H
+#define DETERMINISTICREDUCTION_H
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+// Parallel reductions whose result does not depend on the number of threads.
+//
+// The index range is cut into fixed-size blocks (independent of thread count), each block
+// is reduced sequentially, and the block results are combined in a fixed pairwise tree.
+// The floating-point operation order is therefore identical for any OpenMP team size,
+// which keeps replay and regression hashes stable when threads are added.
+
+constexpr std::size_t reductionBlockSize = 256;
+
+// Pairwise (cascade) sum of values[0, count) in a fixed order
+inline double pairwiseSum(const double* values, std::size_t count) {
+    if (count == 0) {
+        return 0.0;
+    }
+    if (count == 1) {
+        return values[0];
+    }
+    std::size_t half = count / 2;
+    return pairwiseSum(values, half) + pairwiseSum(values + half, count - half);
+}
+
+// Sum of term(i) for i in [0, count). term may also update per-index state, since
+// every index is visited exactly once.
+template <typename Term>
+double deterministicSum(std::size_t count, Term&& term) {
+    const std::size_t blockCount = (count + reductionBlockSize - 1) / reductionBlockSize;
+    std::vector<double> partials(blockCount, 0.0);
+
+#pragma omp parallel for schedule(static)
+    for (std::ptrdiff_t b = 0; b < static_cast<std::ptrdiff_t>(blockCount); ++b) {
+        const std::size_t begin = static_cast<std::size_t>(b) * reductionBlockSize;
+        const std::size_t end = std::min(begin + reductionBlockSize, count);
+
+        double sum = 0.0;
+        for (std::size_t i = begin; i < end; ++i) {
+            sum += term(i);
+        }
+        partials[b] = sum;
+    }
+
+    return pairwiseSum(partials.data(), blockCount);
+}
+
+// Maximum of value(i) for i in [0, count), or initial if count is 0.
+// Max is order independent, but shares the block structure so the two reductions
+// can be swapped without changing how work is split.
+template <typename Value>
+double deterministicMax(std::size_t count, Value&& value,
+                        double initial = std::numeric_limits<double>::lowest()) {
+    const std::size_t blockCount = (count + reductionBlockSize - 1) / reductionBlockSize;
+    std::vector<double> partials(blockCount, initial);
+
+#pragma omp parallel for schedule(static)
+    for (std::ptrdiff_t b = 0; b < static_cast<std::ptrdiff_t>(blockCount); ++b) {
+        const std::size_t begin = static_cast<std::size_t>(b) * reductionBlockSize;
+        const std::size_t end = std::min(begin + reductionBlockSize, count);
+
+        double result = initial;
+        for (std::size_t i = begin; i < end; ++i) {
+            result = std::max(result, value(i));
+        }
+        partials[b] = result;
+    }
+
+    double result = initial;
+    for (double partial : partials) {
+        result = std::max(result, partial);
+    }
+    return result;
+}
+
+#endif // DETERMINISTICREDUCTION_H
@@ -0,0 +1,149 @@
+// Ensemble.cpp
+
+#include "Ensemble.h"
+#include <algorithm>
+#include <thread>
+
+namespace {
+
+SimulationOptions instanceOptions(const EnsembleConfig& config) {
+    SimulationOptions options;
+    options.interactive = false;
+    options.realTime = false; // The ensemble owns the frame clock
+    options.fixedTimeStep = config.timeStep;
+    options.keepHistory = config.keepHistory;
+    options.verbose = false;
+    options.externalCorePhysics = config.batchWidth > 1 && !config.pointKinetics;
+    options.pointKinetics = config.pointKinetics;
+    options.fluxSubsteps = std::max(1, config.fluxSubsteps);
+    return options;
+}
+
+} // namespace
+
+Ensemble::Instance::Instance(const EnsembleConfig& config)
+    : core(config.xSize, config.ySize, config.zSize),
+      coolantSystem(config.coolantLoops, config.coolantChunks),
+      running(true),
+      simulation(core, coolantSystem, running, instanceOptions(config)),
+      deadlineMisses(0),
+      lastStepTime(0.0) {}
+
+Ensemble::Ensemble(const EnsembleConfig& config)
+    : config(config),
+      pool(config.threadCount) {
+    instances.reserve(config.instanceCount);
+    for (int i = 0; i < config.instanceCount; ++i) {
+        instances.push_back(std::make_unique<Instance>(config));
+    }
+
+    if (config.batchWidth > 1 && !config.pointKinetics) {
+        for (int first = 0; first < config.instanceCount; first += config.batchWidth) {
+            batches.push_back(std::make_unique<Batch>(config, first,
+                                                      std::min(config.batchWidth, config.instanceCount - first)));
+        }
+    }
+}
+
+Ensemble::Batch::Batch(const EnsembleConfig& config, int first, int count)
+    : first(first),
+      core(config.xSize, config.ySize, config.zSize, count) {}
+
+void Ensemble::run(std::atomic<bool>& running) {
+    const auto frame = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(config.timeStep));
+
+    auto deadline = std::chrono::steady_clock::now() + frame;
+    while (running.load()) {
+        stepAll(deadline);
+
+        auto now = std::chrono::steady_clock::now();
+        if (now < deadline) {
+            std::this_thread::sleep_until(deadline);
+            deadline += frame;
+        } else {
+            // Behind schedule: start the next frame now instead of trying to catch up
+            deadline = now + frame;
+        }
+    }
+}
+
+void Ensemble::stepAll(std::chrono::steady_clock::time_point deadline) {
+    if (!batches.empty()) {
+        pool.parallelFor(batches.size(), [&](std::size_t b) { stepBatch(*batches[b], deadline); });
+        return;
+    }
+
+    pool.parallelFor(instances.size(), [&](std::size_t i) { stepInstance(*instances[i], deadline); });
+}
+
+void Ensemble::stepInstance(Instance& instance, std::chrono::steady_clock::time_point deadline) {
+    if (!instance.running.load()) {
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    instance.simulation.step();
+    auto end = std::chrono::steady_clock::now();
+
+    instance.lastStepTime.store(std::chrono::duration<double>(end - start).count());
+    if (end > deadline) {
+        instance.deadlineMisses.fetch_add(1);
+    }
+}
+
+void Ensemble::stepBatch(Batch& batch, std::chrono::steady_clock::time_point deadline) {
+    auto start = std::chrono::steady_clock::now();
+    const int lanes = batch.core.getLaneCount();
+
+    // Commands (rod moves, rewinds) land in the Cores before they are loaded into the lanes.
+    // Stopped instances still occupy their lane; their results are simply not stored.
+    for (int lane = 0; lane < lanes; ++lane) {
+        Instance& instance = *instances[batch.first + lane];
+        if (instance.running.load()) {
+            instance.simulation.beginStep();
+        }
+        std::lock_guard<std::mutex> lock(instance.core.getMutex());
+        batch.core.load(lane, instance.core);
+    }
+
+    batch.core.advance(config.timeStep, std::max(1, config.fluxSubsteps));
+
+    for (int lane = 0; lane < lanes; ++lane) {
+        Instance& instance = *instances[batch.first + lane];
+        if (!instance.running.load()) {
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(instance.core.getMutex());
+            batch.core.store(lane, instance.core);
+        }
+        instance.simulation.finishStep();
+    }
+
+    // The lanes finish together, so every instance in the batch is charged the batch time
+    auto end = std::chrono::steady_clock::now();
+    for (int lane = 0; lane < lanes; ++lane) {
+        Instance& instance = *instances[batch.first + lane];
+        instance.lastStepTime.store(std::chrono::duration<double>(end - start).count());
+        if (end > deadline) {
+            instance.deadlineMisses.fetch_add(1);
+        }
+    }
+}
+
+void Ensemble::submitCommand(int instance, const std::string& command) {
+    instances.at(instance)->simulation.submitCommand(command);
+}
+
+PlantTelemetry Ensemble::getTelemetry(int instance) const {
+    return instances.at(instance)->simulation.getTelemetry();
+}
+
+std::uint64_t Ensemble::getDeadlineMisses(int instance) const {
+    return instances.at(instance)->deadlineMisses.load();
+}
+
+double Ensemble::getLastStepTime(int instance) const {
+    return instances.at(instance)->lastStepTime.load();
+}
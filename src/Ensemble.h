@@ -0,0 +1,85 @@
+// Ensemble.h
+
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BatchedCore.h"
+#include "Core.h"
+#include "CoolantSystem.h"
+#include "MainSimulation.h"
+#include "PlantTelemetry.h"
+#include "WorkerPool.h"
+
+struct EnsembleConfig {
+    int instanceCount = 30;
+    int xSize = 10, ySize = 10, zSize = 10;
+    int coolantChunks = 100;    // Per loop
+    int coolantLoops = 1;      // Stepped in turn: the instances already fill the pool
+    double timeStep = 0.033;   // Seconds per frame; also each instance's step deadline
+    std::size_t threadCount = 0; // 0 = one per hardware thread
+    bool keepHistory = false;  // Rewind buffers cost one encoder thread per instance
+    int batchWidth = 1;        // Instances whose Core kernels run together in one BatchedCore (1 = off)
+    int fluxSubsteps = 1;      // See SimulationOptions
+    bool pointKinetics = false; // Point-kinetics cores (never batched: there is no spatial kernel to batch)
+};
+
+// Hosts many independent reactor instances (Core + CoolantSystem + protection logic) in one
+// process and steps them together on a shared worker pool. Each instance has its own
+// command queue and published telemetry, so stations never see each other's state.
+//
+// With batchWidth > 1 the instances are grouped into BatchedCores: each frame a batch loads
+// its instances' cores, advances them together across SIMD lanes and stores them back, while
+// commands, coolant and protection still run per instance. Batches are the unit of parallelism.
+class Ensemble {
+public:
+    explicit Ensemble(const EnsembleConfig& config);
+
+    // Steps every instance once per frame until running is cleared
+    void run(std::atomic<bool>& running);
+
+    // Steps every active instance once; steps finishing after the deadline count as misses
+    void stepAll(std::chrono::steady_clock::time_point deadline);
+
+    void submitCommand(int instance, const std::string& command);
+    [[nodiscard]] PlantTelemetry getTelemetry(int instance) const;
+    [[nodiscard]] std::uint64_t getDeadlineMisses(int instance) const;
+    [[nodiscard]] double getLastStepTime(int instance) const;
+
+    [[nodiscard]] int getInstanceCount() const { return static_cast<int>(instances.size()); }
+    [[nodiscard]] std::size_t getThreadCount() const { return pool.getThreadCount(); }
+
+private:
+    struct Instance {
+        explicit Instance(const EnsembleConfig& config);
+
+        Core core;
+        CoolantSystem coolantSystem;
+        std::atomic<bool> running;
+        MainSimulation simulation;
+        std::atomic<std::uint64_t> deadlineMisses;
+        std::atomic<double> lastStepTime; // Seconds of CPU time spent in the last step
+    };
+
+    struct Batch {
+        Batch(const EnsembleConfig& config, int first, int count);
+
+        int first; // Index of the instance in lane 0
+        BatchedCore core;
+    };
+
+    EnsembleConfig config;
+    std::vector<std::unique_ptr<Instance>> instances;
+    std::vector<std::unique_ptr<Batch>> batches;
+    WorkerPool pool;
+
+    void stepInstance(Instance& instance, std::chrono::steady_clock::time_point deadline);
+    void stepBatch(Batch& batch, std::chrono::steady_clock::time_point deadline);
+};
+
+#endif // ENSEMBLE_H
@@ -0,0 +1,127 @@
+// EnsembleDriver.cpp
+//
+// Runs a whole classroom of trainee stations in one process.
+//
+//   EnsembleDriver [--instances N] [--threads T] [--size S] [--chunks C] [--loops L] [--batch K] [--point-kinetics]
+//                  [--benchmark seconds]
+//
+// Interactive commands (stdin):
+//   <n> <command>     Send an operator command to station n (e.g. "3 adjust rods 0.5")
+//   all <command>     Send a command to every station
+//   status            Print one line of telemetry per station
+//   exit              Stop
+//
+// --batch K steps the Core kernels of K stations at a time across SIMD lanes (BatchedCore).
+// --benchmark runs unthrottled for the given simulated time and reports throughput.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "Ensemble.h"
+
+namespace {
+
+void printStatus(const Ensemble& ensemble) {
+    std::cout << "station  time[s]  maxTemp[K]  rods[%]  scram  stepTime[ms]  missed\n";
+    for (int i = 0; i < ensemble.getInstanceCount(); ++i) {
+        PlantTelemetry telemetry = ensemble.getTelemetry(i);
+        std::cout << i << "  " << telemetry.simTime << "  " << telemetry.maxCoreTemperature << "  "
+                  << telemetry.controlRodInsertion * 100.0 << "  " << (telemetry.scramInitiated ? "yes" : "no") << "  "
+                  << ensemble.getLastStepTime(i) * 1000.0 << "  " << ensemble.getDeadlineMisses(i) << "\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    EnsembleConfig config;
+    double benchmarkSeconds = 0.0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--instances" && i + 1 < argc) {
+            config.instanceCount = std::stoi(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            config.threadCount = std::stoul(argv[++i]);
+        } else if (arg == "--size" && i + 1 < argc) {
+            config.xSize = config.ySize = config.zSize = std::stoi(argv[++i]);
+        } else if (arg == "--chunks" && i + 1 < argc) {
+            config.coolantChunks = std::stoi(argv[++i]);
+        } else if (arg == "--loops" && i + 1 < argc) {
+            config.coolantLoops = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--batch" && i + 1 < argc) {
+            config.batchWidth = std::stoi(argv[++i]);
+        } else if (arg == "--point-kinetics") {
+            config.pointKinetics = true;
+        } else if (arg == "--benchmark" && i + 1 < argc) {
+            benchmarkSeconds = std::stod(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--instances N] [--threads T] [--size S] [--chunks C] [--loops L] [--batch K] [--point-kinetics]"
+                      << " [--benchmark seconds]" << std::endl;
+            return 1;
+        }
+    }
+
+    Ensemble ensemble(config);
+    std::cout << "Hosting " << ensemble.getInstanceCount() << " stations on "
+              << ensemble.getThreadCount() << " threads." << std::endl;
+
+    if (benchmarkSeconds > 0.0) {
+        auto start = std::chrono::steady_clock::now();
+        std::uint64_t frames = 0;
+        while (ensemble.getTelemetry(0).simTime < benchmarkSeconds) {
+            ensemble.stepAll(std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                 std::chrono::duration<double>(config.timeStep)));
+            ++frames;
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << frames << " frames x " << ensemble.getInstanceCount() << " stations in " << elapsed.count()
+                  << " s: " << frames * ensemble.getInstanceCount() / elapsed.count() << " instance-steps/s, "
+                  << benchmarkSeconds / elapsed.count() << "x real time" << std::endl;
+        return 0;
+    }
+
+    std::atomic<bool> running(true);
+    std::thread ensembleThread(&Ensemble::run, &ensemble, std::ref(running));
+
+    std::string line;
+    while (running.load() && std::getline(std::cin, line)) {
+        std::istringstream fields(line);
+        std::string target;
+        fields >> target >> std::ws;
+        std::string command;
+        std::getline(fields, command);
+
+        if (target == "exit") {
+            break;
+        } else if (target == "status") {
+            printStatus(ensemble);
+        } else if (target == "all" && !command.empty()) {
+            for (int i = 0; i < ensemble.getInstanceCount(); ++i) {
+                ensemble.submitCommand(i, command);
+            }
+        } else {
+            try {
+                int station = std::stoi(target);
+                if (station < 0 || station >= ensemble.getInstanceCount() || command.empty()) {
+                    throw std::out_of_range("station");
+                }
+                ensemble.submitCommand(station, command);
+            } catch (...) {
+                std::cout << "Usage: <station> <command> | all <command> | status | exit\n";
+            }
+        }
+    }
+
+    running.store(false);
+    ensembleThread.join();
+    return 0;
+}
@@ -0,0 +1,154 @@
+// HeatConduction.cpp
+
+#include "HeatConduction.h"
+#include <algorithm>
+#include <span>
+#include "Core.h"
+#include "TridiagonalSolver.h"
+#include "WorkerPool.h"
+
+HeatConduction::Lines HeatConduction::linesAlong(const Core& core, int axis) {
+    const auto xSize = static_cast<std::size_t>(core.getXSize());
+    const auto ySize = static_cast<std::size_t>(core.getYSize());
+    const auto zSize = static_cast<std::size_t>(core.getZSize());
+    switch (axis) {
+        case 0: // One line per (y, z)
+            return { ySize * zSize, xSize, ySize * zSize, ySize * zSize, 1, 0 };
+        case 1: // One line per (x, z)
+            return { xSize * zSize, ySize, zSize, zSize, 1, ySize * zSize };
+        default: // One line per (x, y), contiguous
+            return { xSize * ySize, zSize, 1, xSize * ySize, zSize, 0 };
+    }
+}
+
+void HeatConduction::updateConductances(const Core& core) {
+    const auto& elements = core.getElements();
+    heatCapacity.resize(elements.size());
+    for (std::size_t i = 0; i < elements.size(); ++i) {
+        heatCapacity[i] = elements[i].getHeatCapacity();
+    }
+
+    for (int axis = 0; axis < 3; ++axis) {
+        const Lines lines = linesAlong(core, axis);
+        auto& conductance = faceConductance[axis];
+        conductance.assign(elements.size(), 0.0); // The last cell of a line faces the insulated boundary
+        for (std::size_t line = 0; line < lines.count; ++line) {
+            std::size_t cell = lines.start(line);
+            for (std::size_t k = 0; k + 1 < lines.length; ++k, cell += lines.stride) {
+                const double a = elements[cell].getThermalConductivity();
+                const double b = elements[cell + lines.stride].getThermalConductivity();
+                conductance[cell] = 2.0 * cellSize * a * b / (a + b);
+            }
+        }
+    }
+    conductanceRevision = core.getMaterialRevision();
+}
+
+void HeatConduction::computeConduction(const Core& core) {
+    // Heat flowing into each cell along each axis at the start-of-step temperatures
+    for (int axis = 0; axis < 3; ++axis) {
+        const Lines lines = linesAlong(core, axis);
+        const auto& conductance = faceConductance[axis];
+        auto& flow = conduction[axis];
+        flow.assign(temperature.size(), 0.0);
+        for (std::size_t line = 0; line < lines.count; ++line) {
+            std::size_t cell = lines.start(line);
+            for (std::size_t k = 0; k + 1 < lines.length; ++k, cell += lines.stride) {
+                const std::size_t next = cell + lines.stride;
+                const double heat = conductance[cell] * (temperature[next] - temperature[cell]);
+                flow[cell] += heat;
+                flow[next] -= heat;
+            }
+        }
+    }
+}
+
+void HeatConduction::solveLines(const Core& core, int axis, double deltaTime, WorkerPool* pool) {
+    // Solves (C - dt K) x = stage along every line of the axis, in place. Lines are gathered
+    // linesPerBlock at a time into interleaved systems; blocks are independent and use their
+    // own slice of the buffers, so they can go to the pool in any order.
+    const Lines lines = linesAlong(core, axis);
+    const auto& conductance = faceConductance[axis];
+    const std::size_t blockCount = (lines.count + linesPerBlock - 1) / linesPerBlock;
+    lower.resize(stage.size());
+    diagonal.resize(stage.size());
+    upper.resize(stage.size());
+    rhs.resize(stage.size());
+
+    auto solveBlock = [&](std::size_t block) {
+        const std::size_t first = block * linesPerBlock;
+        const std::size_t width = std::min(linesPerBlock, lines.count - first);
+        const std::size_t offset = first * lines.length;
+        const std::span<double> blockLower(lower.data() + offset, width * lines.length);
+        const std::span<double> blockDiagonal(diagonal.data() + offset, width * lines.length);
+        const std::span<double> blockUpper(upper.data() + offset, width * lines.length);
+        const std::span<double> blockRhs(rhs.data() + offset, width * lines.length);
+
+        for (std::size_t j = 0; j < width; ++j) {
+            double before = 0.0; // Conductance to the previous cell of the line
+            std::size_t cell = lines.start(first + j);
+            for (std::size_t k = 0; k < lines.length; ++k, cell += lines.stride) {
+                const double after = conductance[cell];
+                const std::size_t row = k * width + j;
+                blockLower[row] = -deltaTime * before;
+                blockUpper[row] = -deltaTime * after;
+                blockDiagonal[row] = heatCapacity[cell] + deltaTime * (before + after);
+                blockRhs[row] = stage[cell];
+                before = after;
+            }
+        }
+
+        solveTridiagonalBatch(width, blockLower, blockDiagonal, blockUpper, blockRhs);
+
+        for (std::size_t j = 0; j < width; ++j) {
+            std::size_t cell = lines.start(first + j);
+            for (std::size_t k = 0; k < lines.length; ++k, cell += lines.stride) {
+                stage[cell] = blockRhs[k * width + j];
+            }
+        }
+    };
+
+    if (pool && blockCount > 1) {
+        pool->parallelFor(blockCount, solveBlock);
+    } else {
+        for (std::size_t block = 0; block < blockCount; ++block) {
+            solveBlock(block);
+        }
+    }
+}
+
+void HeatConduction::advance(Core& core, double deltaTime, WorkerPool* pool) {
+    auto& elements = core.getElements();
+    if (elements.empty() || deltaTime <= 0.0) {
+        return;
+    }
+    if (conductanceRevision != core.getMaterialRevision() || heatCapacity.size() != elements.size()) {
+        updateConductances(core);
+    }
+
+    const std::size_t cellCount = elements.size();
+    temperature.resize(cellCount);
+    stage.resize(cellCount);
+    for (std::size_t i = 0; i < cellCount; ++i) {
+        temperature[i] = elements[i].getTemperature();
+    }
+    computeConduction(core);
+
+    // x sweep: implicit in x, explicit in y and z
+    for (std::size_t i = 0; i < cellCount; ++i) {
+        stage[i] = heatCapacity[i] * temperature[i] + deltaTime * (conduction[1][i] + conduction[2][i]);
+    }
+    solveLines(core, 0, deltaTime, pool);
+
+    // y and z sweeps: each corrects its own axis to implicit
+    for (int axis = 1; axis < 3; ++axis) {
+        for (std::size_t i = 0; i < cellCount; ++i) {
+            stage[i] = heatCapacity[i] * stage[i] - deltaTime * conduction[axis][i];
+        }
+        solveLines(core, axis, deltaTime, pool);
+    }
+
+    for (std::size_t i = 0; i < cellCount; ++i) {
+        elements[i].setTemperature(stage[i]);
+    }
+}
@@ -0,0 +1,67 @@
+// HeatConduction.h
+
+#ifndef HEATCONDUCTION_H
+#define HEATCONDUCTION_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Core;
+class WorkerPool;
+
+// Heat conduction between face neighbours of the core grid, fuel, rods and vessel alike. Each
+// cell is a cube of cellSize, and two neighbours conduct through their half cells in series:
+//
+//   G = 2 cellSize k_a k_b / (k_a + k_b)   (W/K)
+//
+// The outer faces of the box are insulated. A step is the Douglas-Rachford alternating-direction
+// implicit scheme, with C the cell heat capacities and Kx, Ky, Kz the conduction along each axis:
+//
+//   (C - dt Kx) T1 = (C + dt Ky + dt Kz) T
+//   (C - dt Ky) T2 = C T1 - dt Ky T
+//   (C - dt Kz) T' = C T2 - dt Kz T
+//
+// Every sweep is a set of independent tridiagonal solves along the grid lines of one axis,
+// gathered in blocks of lines into the interleaved layout of solveTridiagonalBatch. The scheme
+// is unconditionally stable in 3D, and as each operator's rows sum to zero the heat in the
+// core is conserved exactly.
+class HeatConduction {
+public:
+    // Conducts heat for one step; the lines of each sweep are shared out over the pool if given
+    void advance(Core& core, double deltaTime, WorkerPool* pool = nullptr);
+
+    static constexpr double cellSize = 0.045; // m, edge of a cell (a kilogram of fuel)
+    static constexpr std::size_t linesPerBlock = 64; // Systems per batched solve
+
+private:
+    std::uint64_t conductanceRevision = ~std::uint64_t{0};
+    std::array<std::vector<double>, 3> faceConductance; // W/K to the next cell along x, y, z
+    std::vector<double> heatCapacity;                    // J/K per cell
+    std::vector<double> temperature;                     // Per cell, at the start of the step
+    std::vector<double> stage;                           // Per cell: sweep right-hand side, then solution
+    std::array<std::vector<double>, 3> conduction;       // Kx T, Ky T, Kz T at the start of the step (W)
+
+    // The line systems of a sweep, block after block, each block interleaved by line
+    std::vector<double> lower, diagonal, upper, rhs;
+
+    // The grid lines along one axis: line l starts at cell
+    // (l / innerCount) * outerStride + (l % innerCount) * innerStride
+    struct Lines {
+        std::size_t count;
+        std::size_t length;
+        std::size_t stride; // Between cells of a line
+        std::size_t innerCount, innerStride, outerStride;
+        [[nodiscard]] std::size_t start(std::size_t line) const {
+            return (line / innerCount) * outerStride + (line % innerCount) * innerStride;
+        }
+    };
+    [[nodiscard]] static Lines linesAlong(const Core& core, int axis);
+
+    void updateConductances(const Core& core);
+    void computeConduction(const Core& core);
+    void solveLines(const Core& core, int axis, double deltaTime, WorkerPool* pool);
+};
+
+#endif // HEATCONDUCTION_H
@@ -5,18 +5,46 @@
 // MainSimulation.cpp
 
 #include "MainSimulation.h"
+#include <algorithm>
+#include <cctype>
 #include <iostream>
 #include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
 #include <thread>
 #include "Core.h"
+#include "DeterministicReduction.h"
 
-MainSimulation::MainSimulation(Core& core, CoolantLoop& coolantLoop, std::atomic<bool>& running)
+MainSimulation::MainSimulation(Core& core, CoolantSystem& coolantSystem, std::atomic<bool>& running,
+                               const SimulationOptions& options)
     : core(core),
-      coolantLoop(coolantLoop),
+      coolantSystem(coolantSystem),
+      options(options),
       running(running),
       paused(false) {
+    // A journaled or unthrottled session cannot use measured step sizes
+    if ((!this->options.journalPath.empty() || !this->options.realTime) && this->options.fixedTimeStep <= 0.0) {
+        this->options.fixedTimeStep = 0.033;
+    }
+    if (this->options.fixedTimeStep > 0.0) {
+        deltaTime = this->options.fixedTimeStep;
+    }
+    this->options.fluxSubsteps = std::max(1, this->options.fluxSubsteps);
+
+    if (this->options.keepHistory) {
+        history = std::make_unique<SessionHistory>();
+    }
+
+    if (!this->options.scenarioPath.empty() && !scenario.load(this->options.scenarioPath)) {
+        std::cerr << "Continuing without scenario." << std::endl;
+    }
+
     // Start the input thread
-    inputThread = std::thread(&MainSimulation::handleUserInput, this);
+    if (this->options.interactive) {
+        inputThread = std::thread(&MainSimulation::handleUserInput, this);
+    }
 }
 
 
@@ -31,6 +59,18 @@ void MainSimulation::runSimulation() {
     // Target iteration time in milliseconds
     const double targetIterationTime = 33.0; // For ~30 FPS
 
+    if (!options.journalPath.empty()) {
+        JournalModel model;
+        model.pointKinetics = options.pointKinetics;
+        model.fluxSubsteps = options.fluxSubsteps;
+        model.burnupInterval = options.burnupInterval;
+        model.conductionInterval = options.conductionInterval;
+        model.adaptiveStep = options.adaptiveStep;
+        model.stepTolerance = options.stepTolerance;
+        journal.open(options.journalPath, options.fixedTimeStep, core, coolantSystem, model,
+                     computeStateHash(core, coolantSystem, protectiveLogic.isScramInitiated()));
+    }
+
     while (running.load()) {
         if (paused.load()) {
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
@@ -42,25 +82,33 @@ void MainSimulation::runSimulation() {
 
         auto startTime = std::chrono::high_resolution_clock::now();
 
-
-        iterate();
-        updateDisplay();
+        step();
 
         auto endTime = std::chrono::high_resolution_clock::now();
         std::chrono::duration<double> elapsedTime = endTime - startTime;
 
-        // Update deltaTime based on actual elapsed time
-        deltaTime = elapsedTime.count(); // deltaTime in seconds
+        double sleepTime;
+        if (options.fixedTimeStep > 0.0) {
+            // Fixed step: only the sleep absorbs variations in iteration time
+            sleepTime = options.fixedTimeStep - elapsedTime.count();
+        } else {
+            // Update deltaTime based on actual elapsed time
+            deltaTime = elapsedTime.count(); // deltaTime in seconds
+
+            // After updating deltaTime
+            if (deltaTime < minDeltaTime) {
+                deltaTime = minDeltaTime;
+            } else if (deltaTime > maxDeltaTime) {
+                deltaTime = maxDeltaTime;
+            }
 
-        // After updating deltaTime
-        if (deltaTime < minDeltaTime) {
-            deltaTime = minDeltaTime;
-        } else if (deltaTime > maxDeltaTime) {
-            deltaTime = maxDeltaTime;
+            // Sleep if necessary to maintain target iteration time
+            sleepTime = targetIterationTime / 1000.0 - deltaTime; // Convert target to seconds
         }
 
-        // Sleep if necessary to maintain target iteration time
-        double sleepTime = targetIterationTime / 1000.0 - deltaTime; // Convert target to seconds
+        if (!options.realTime) {
+            continue;
+        }
 
         if (sleepTime > 0) {
             std::this_thread::sleep_for(std::chrono::duration<double>(sleepTime));
@@ -69,162 +117,477 @@ void MainSimulation::runSimulation() {
                       << -sleepTime * 1000.0 << " ms." << std::endl;
         }
     }
+
+    if (journal.isOpen()) {
+        journal.finish(stepCount, computeStateHash(core, coolantSystem, protectiveLogic.isScramInitiated()));
+    }
 }
 
-void MainSimulation::iterate() {
+bool MainSimulation::replay(const CommandJournal& sessionJournal) {
+    deltaTime = sessionJournal.timeStep;
+    if (history) {
+        history->setBlocking(true);
+    }
+
+    if (computeStateHash(core, coolantSystem, protectiveLogic.isScramInitiated()) != sessionJournal.initialStateHash) {
+        std::cout << "Replay aborted: initial state does not match the journal.\n";
+        return false;
+    }
+
+    std::uint64_t endStep = sessionJournal.hasEnd ? sessionJournal.endStep
+                            : (sessionJournal.entries.empty() ? 0 : sessionJournal.entries.back().step + 1);
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    std::size_t next = 0;
+    while (stepCount < endStep && running.load()) {
+        while (next < sessionJournal.entries.size() && sessionJournal.entries[next].step == stepCount) {
+            applyCommand(sessionJournal.entries[next].command);
+            ++next;
+        }
+        stepOnce();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+    std::uint64_t finalHash = computeStateHash(core, coolantSystem, protectiveLogic.isScramInitiated());
+
+    std::cout << "Replayed " << stepCount << " steps (" << simTime << " s simulated) in "
+              << elapsed.count() << " s.\n";
+
+    if (!sessionJournal.hasEnd) {
+        std::cout << "Journal has no end record; final state not verified.\n";
+        return true;
+    }
+
+    bool match = finalHash == sessionJournal.finalStateHash;
+    std::cout << "Final state " << std::hex << finalHash << std::dec
+              << (match ? " matches the journal.\n" : " does NOT match the journal.\n");
+    return match;
+}
+
+void MainSimulation::step() {
+    beginStep();
+    finishStep();
+}
+
+void MainSimulation::beginStep() {
+    applyPendingCommands();
+}
+
+void MainSimulation::finishStep() {
+    stepOnce();
+}
+
+void MainSimulation::stepOnce() {
+    iterate();
+    updateDisplay();
+
+    if (options.adaptiveStep && !options.realTime && options.journalPath.empty() && !options.externalCorePhysics) {
+        chooseNextTimeStep();
+    }
+
+    if (scenario.isLoaded()) {
+        std::vector<std::string> commands;
+        scenario.evaluate(telemetry, commands);
+        for (const auto& command : commands) {
+            if (options.verbose) {
+                std::lock_guard<std::mutex> lock(ioMutex);
+                std::cout << "Scenario at t = " << simTime << " s: " << command << "\n";
+            }
+            submitCommand(command);
+        }
+
+        if (scenario.isFinished(telemetry)) {
+            running.store(false);
+        }
+    }
+
+    if (history) {
+        history->capture(simTime, protectiveLogic.isScramInitiated(), core, coolantSystem);
+    }
+    if (recorder) {
+        recorder->record(telemetry, core, coolantSystem);
+    }
+}
+
+void MainSimulation::submitCommand(const std::string& command) {
+    std::lock_guard<std::mutex> lock(commandMutex);
+    pendingCommands.push_back(command);
+}
+
+void MainSimulation::applyPendingCommands() {
+    std::vector<std::string> commands;
     {
-        std::lock_guard<std::mutex> lock(core.getMutex());
-        // Calculate neutron flux
-        core.calculateMultiGroupNeutronFlux(deltaTime);
+        std::lock_guard<std::mutex> lock(commandMutex);
+        commands.swap(pendingCommands);
+    }
+
+    for (const auto& command : commands) {
+        std::string applied = applyCommand(command);
+        if (!applied.empty() && journal.isOpen()) {
+            journal.record(stepCount, applied);
+        }
+    }
+}
 
-        // Update burnup (fuel depletion)
-        core.updateFuelBurnup(deltaTime);
+std::string MainSimulation::applyCommand(const std::string& command) {
+    // Returns the command as it should be journaled, or an empty string if nothing changed
+    try {
+        if (command.find("adjust rods") == 0) {
+            double depth = std::stod(command.substr(12));
+            return adjustControlRods(depth) ? command : std::string();
+        }
+        if (command.find("adjust bank") == 0) {
+            std::istringstream arguments(command.substr(12));
+            int bank = 0;
+            double depth = 0.0;
+            if (arguments >> bank >> depth) {
+                return adjustRodBank(bank, depth) ? command : std::string();
+            }
+        }
+        if (command.find("initiate casualty") == 0) {
+            return initiateCasualty(command.substr(18)) ? command : std::string();
+        }
+        if (command.find("rewind to") == 0) {
+            return rewindTo(std::stod(command.substr(10))) ? command : std::string();
+        }
+        if (command.find("rewind") == 0) {
+            // Journal the frame actually restored so replay lands on the same one
+            if (!rewindTo(simTime - std::stod(command.substr(7)))) {
+                return {};
+            }
+            std::ostringstream canonical;
+            canonical << "rewind to " << std::setprecision(17) << simTime;
+            return canonical.str();
+        }
+    } catch (...) {
+        // Fall through to the error below
+    }
+
+    std::lock_guard<std::mutex> lock(ioMutex);
+    std::cout << "Could not apply command: " << command << "\n";
+    return {};
+}
+
+void MainSimulation::iterate() {
+    if (options.pointKinetics) {
+        std::lock_guard<std::mutex> lock(core.getMutex());
+        core.calculatePointKinetics(deltaTime);
+    } else if (!options.externalCorePhysics) {
+        std::lock_guard<std::mutex> lock(core.getMutex());
+        // Calculate neutron flux (fast kinetics, subcycled)
+        if (options.adaptiveStep) {
+            fluxSubstepCount += core.advanceFluxAdaptive(deltaTime, options.stepTolerance, fluxStep);
+        } else {
+            for (int substep = 0; substep < options.fluxSubsteps; ++substep) {
+                core.calculateMultiGroupNeutronFlux(deltaTime / options.fluxSubsteps);
+            }
+            fluxSubstepCount += options.fluxSubsteps;
+        }
 
         // Update core thermals (temperature calculations)
         core.calculateCoreThermals(deltaTime);
     }
 
-    {
-        std::lock_guard<std::mutex> lock(coolantLoop.getMutex());
-        // Advance coolant loop and update chunks
-        coolantLoop.advanceLoop();
-        coolantLoop.updateCoolantChunks();
+    // Conduction between neighbouring cells, whichever kernels made the heat. It depends only
+    // on simulated time when it runs, so rewinds and replays conduct at the same steps.
+    const double conductionInterval = options.conductionInterval;
+    const double conductionTime = conductionInterval > 0.0
+        ? conductionInterval * (std::floor((simTime + deltaTime) / conductionInterval) - std::floor(simTime / conductionInterval))
+        : deltaTime;
+    if (conductionTime > 0.0) {
+        std::lock_guard<std::mutex> lock(core.getMutex());
+        heatConduction.advance(core, conductionTime, options.workerPool);
     }
 
+    {
+        // Burnup (fuel depletion) and rods run after the physics so externally stepped cores
+        // see the same sequence. Burnup only reads the flux, so it can follow the thermals.
+        std::lock_guard<std::mutex> lock(core.getMutex());
+        core.advanceBurnup(deltaTime, options.burnupInterval);
 
-    // Exchange heat between core and coolant
-    exchangeHeat();
-
-    // Evaluate protective actions
-    evaluateProtection();
+        bool scramComplete = core.isScramComplete();
+        core.moveControlRods(deltaTime);
+        if (!scramComplete && core.isScramComplete() && options.verbose) {
+            std::cout << "Control rods fully inserted " << core.getTimeSinceScram() << " s after scram." << std::endl;
+        }
+    }
 
-    double maxCoreTemp = getMaxCoreTemperature();
-    double upperCoolantTemp = coolantLoop.getUpperChunk().getTemperature();
-    double lowerCoolantTemp = coolantLoop.getLowerChunk().getTemperature();
+    // Exchange heat between core and coolant channels
+    double coreHeat = 0.0;
+    double totalPower = exchangeHeat(coreHeat);
+
+    // Advance the coolant loops with the core heat entering at the outlet, and mix them in
+    // the inlet plenum (each loop locks itself)
+    coolantSystem.advance(deltaTime, coreHeat, options.workerPool);
+
+    // Evaluate protective actions (the scram leaves temperatures alone, so the hottest cell
+    // found here is also this step's telemetry)
+    const double maxCoreTemperature = getMaxCoreTemperature();
+    evaluateProtection(maxCoreTemperature);
+
+    simTime += deltaTime;
+    ++stepCount;
+
+    // Publish this step's plant values
+    telemetry.step = stepCount;
+    telemetry.simTime = simTime;
+    telemetry.maxCoreTemperature = maxCoreTemperature;
+    telemetry.totalPower = totalPower;
+    telemetry.upperCoolantTemperature = coolantSystem.getOutletTemperature();
+    telemetry.lowerCoolantTemperature = coolantSystem.getInletTemperature();
+    telemetry.coolantFlowRate = coolantSystem.getMassFlowRate();
+    telemetry.hotChannelTemperature = coolantChannels.getMaxOutletTemperature();
+    telemetry.coreVoidFraction = coolantChannels.getMeanVoid();
+    telemetry.steamPower = coolantSystem.getSteamPower();
+    telemetry.coolantInventory = coolantSystem.getInventory();
+    telemetry.pressurizerLevel = coolantSystem.getPressurizerLevel();
+    telemetry.controlRodInsertion = core.getControlRodInsertion();
+    telemetry.scramInitiated = protectiveLogic.isScramInitiated();
+    {
+        std::lock_guard<std::mutex> lock(telemetryMutex);
+        publishedTelemetry = telemetry;
+    }
 
     {
         std::lock_guard<std::mutex> lock(ioMutex);
-        //std::cout << "Iteration: Max Core Temp = " << maxCoreTemp
-        //          << ", Upper Coolant Temp = " << upperCoolantTemp
-        //          << ", Lower Coolant Temp = " << lowerCoolantTemp << std::endl;
+        //std::cout << "Iteration: Max Core Temp = " << telemetry.maxCoreTemperature
+        //          << ", Upper Coolant Temp = " << telemetry.upperCoolantTemperature
+        //          << ", Lower Coolant Temp = " << telemetry.lowerCoolantTemperature << std::endl;
     }
 }
 
+bool MainSimulation::enableRecording(const RecorderConfig& config) {
+    recorder = std::make_unique<TelemetryRecorder>(config, core, coolantSystem);
+    if (!recorder->isOpen()) {
+        recorder.reset();
+        return false;
+    }
+    return true;
+}
+
+PlantTelemetry MainSimulation::getTelemetry() const {
+    std::lock_guard<std::mutex> lock(telemetryMutex);
+    return publishedTelemetry;
+}
+
 void MainSimulation::displayStatus() const {
     double maxTemperature = getMaxCoreTemperature();
-    double upperCoolantTemp = coolantLoop.getUpperChunk().getTemperature();
-    double lowerCoolantTemp = coolantLoop.getLowerChunk().getTemperature();
+    double upperCoolantTemp = coolantSystem.getOutletTemperature();
+    double lowerCoolantTemp = coolantSystem.getInletTemperature();
 
     std::cout << "\nSimulation Status:\n"
               << " - Max Core Temperature: " << maxTemperature << " K\n"
               << " - Upper Coolant Temperature: " << upperCoolantTemp << " K\n"
               << " - Lower Coolant Temperature: " << lowerCoolantTemp << " K\n"
+              << " - Core Void Fraction: " << (coolantChannels.getMeanVoid() * 100) << "%\n"
               << " - Control Rod Insertion: " << (core.getControlRodInsertion() * 100) << "%\n"
-              << " - Coolant Chunks: " << coolantLoop.getChunkCount() << "\n";
+              << " - Coolant Loops: " << coolantSystem.getLoopCount() << "\n"
+              << " - Coolant Inventory: " << coolantSystem.getInventory() << " kg\n"
+              << " - Pressurizer Level: " << (coolantSystem.getPressurizerLevel() * 100) << "%\n"
+              << " - Simulation Time: " << simTime << " s\n";
+
+    if (history) {
+        std::cout << " - Rewind Available: " << (history->getNewestTime() - history->getOldestTime()) << " s ("
+                  << (history->getMemoryUsage() / (1024.0 * 1024.0)) << " MB)\n";
+    }
 }
 
 // MainSimulation.cpp
 
-void MainSimulation::exchangeHeat() {
-    // Simplified heat exchange between core and coolant
-    double totalHeatGenerated = 0.0;
-
-    auto& elements = core.getElements();
-    int xSize = core.getXSize();
-    int ySize = core.getYSize();
-    int zSize = core.getZSize();
-
-    // Accumulate total heat generated
-#pragma omp parallel for collapse(3) reduction(+:totalHeatGenerated) schedule(static)
-    for (int x = 0; x < xSize; ++x) {
-        for (int y = 0; y < ySize; ++y) {
-            for (int z = 0; z < zSize; ++z) {
-                CoreElement& element = elements[core.index(x, y, z)];
-                if (element.getMaterial() == MaterialType::Fuel) {
-                    double neutronPopulation = element.getNeutronPopulation();
-                    double heatGenerated = neutronPopulation * 1000.0; // Scaling factor
-                    totalHeatGenerated += heatGenerated;
-
-                    // Cool the fuel element
-                    double heatRemoved = heatGenerated * 0.5; // Half the heat removed by coolant
-                    element.updateTemperature(-heatRemoved, deltaTime);
-                }
-            }
-        }
-    }
-
-    // Transfer heat to coolant chunks
-    double totalHeatTransferred = totalHeatGenerated * 0.5; // Total heat transferred to coolant
-    double heatPerChunk = totalHeatTransferred / 2.0;       // Split between upper and lower chunks
-
-    coolantLoop.getUpperChunk().absorbHeat(heatPerChunk);
-    coolantLoop.getLowerChunk().absorbHeat(heatPerChunk);
-
-    // No need for further temperature updates here
-}
-
-double MainSimulation::calculateHeatTransferCoefficient(double density, double heatCapacity) const {
-    // Implement your calculation here
-    // For example:
-    return 1000.0; // Placeholder value
+double MainSimulation::exchangeHeat(double& heatTransferred) {
+    // Heat exchange between the fuel and the coolant channels through the core
+    const auto& elements = core.getElements();
+    const auto& fuelCells = core.getFuelCells();
+
+    // Accumulate total heat generated (fixed-order reduction so the result is
+    // independent of the thread count)
+    double totalHeatGenerated = deterministicSum(fuelCells.size(), [&](std::size_t i) {
+        double neutronPopulation = elements[fuelCells[i]].getNeutronPopulation();
+        return neutronPopulation * 1000.0; // Scaling factor
+    });
+
+    // Each fuel cell cools into its channel at the local temperature difference; the
+    // channels are fed from the inlet plenum at the loops' combined flow
+    double inletEnthalpy = coolantSystem.getInletEnthalpy();
+    // The channels' heat leaves the core in the loops as they advance
+    heatTransferred = coolantChannels.exchangeHeat(core, inletEnthalpy, coolantSystem.getMassFlowRate(), deltaTime);
+
+    return totalHeatGenerated;
 }
 
+void MainSimulation::evaluateProtection(double maxCoreTemperature) {
+    // Coolant flow as a fraction of nominal over all loops (drained loops count as zero)
+    double coolantFlowRate = coolantSystem.getFlowFraction();
 
-void MainSimulation::evaluateProtection() {
-    // Get maximum core temperature
-    double maxCoreTemperature = getMaxCoreTemperature();
-
-    // Simulate coolant flow rate (for this example, assume constant)
-    double coolantFlowRate = 1.0;
-
-    // Evaluate protective actions
+    // Evaluate protective actions; the trip is latched, so the rods are released only once
+    bool wasScramInitiated = protectiveLogic.isScramInitiated();
     protectiveLogic.evaluateConditions(maxCoreTemperature, coolantFlowRate);
 
-    if (protectiveLogic.isScramInitiated()) {
-        std::cout << "Scram initiated due to unsafe conditions!" << std::endl;
-        core.insertControlRods();
+    if (protectiveLogic.isScramInitiated() && !wasScramInitiated) {
+        if (options.verbose) {
+            std::cout << "Scram initiated due to unsafe conditions!" << std::endl;
+        }
+        std::lock_guard<std::mutex> lock(core.getMutex());
+        core.scram();
+    }
+}
+
+void MainSimulation::chooseNextTimeStep() {
+    // Embedded estimate for the explicit updates: the change in a temperature's rate over the
+    // step is the leading error term of the Euler step. Both the hottest fuel cell and the core
+    // outlet are watched, so the step also resolves transients carried by the coolant.
+    auto estimate = [&](double temperature, double& previous, double& previousRate) {
+        if (std::isnan(temperature)) {
+            previous = -1.0; // Drained loops: start over once there is an outlet again
+            return 0.0;
+        }
+        double rate = previous < 0.0 ? 0.0 : (temperature - previous) / deltaTime;
+        double error = 0.5 * deltaTime * std::abs(rate - previousRate) / (options.stepTolerance * std::max(temperature, 1.0));
+        previous = temperature;
+        previousRate = rate;
+        return error;
+    };
+    double error = std::max(estimate(telemetry.maxCoreTemperature, previousMaxTemperature, previousTemperatureRate),
+                            estimate(telemetry.upperCoolantTemperature, previousOutletTemperature, previousOutletRate));
+
+    double next = deltaTime * std::clamp(0.9 / std::sqrt(std::max(error, 1e-12)), 0.2, 2.0);
+    next = std::clamp(next, options.minTimeStep, options.maxTimeStep);
+
+    // Rod motion is resolved per step
+    bool rodsMoving;
+    {
+        std::lock_guard<std::mutex> lock(core.getMutex());
+        rodsMoving = core.areRodsMoving();
     }
+    if (rodsMoving) {
+        next = std::min(next, options.fixedTimeStep);
+    }
+    deltaTime = next;
 }
 
-void MainSimulation::adjustControlRods(double insertionDepth) const {
+bool MainSimulation::adjustControlRods(double insertionDepth) const {
     if (insertionDepth < 0.0 || insertionDepth > 1.0) {
         std::cout << "Insertion depth must be between 0.0 and 1.0.\n";
-        return;
+        return false;
     }
 
     // Pass the insertion depth to the core
-    core.setControlRodInsertion(insertionDepth);
-    std::cout << "Control rods adjusted to " << (insertionDepth * 100) << "% insertion.\n";
+    bool moved;
+    {
+        std::lock_guard<std::mutex> lock(core.getMutex());
+        moved = core.setControlRodInsertion(insertionDepth);
+    }
+    if (!moved) {
+        std::cout << "Control rods are tripped and cannot be driven.\n";
+        return false;
+    }
+    if (options.verbose) {
+        std::cout << "Control rods moving to " << (insertionDepth * 100) << "% insertion.\n";
+    }
+    return true;
+}
+
+bool MainSimulation::adjustRodBank(int bank, double insertionDepth) const {
+    bool moved;
+    {
+        std::lock_guard<std::mutex> lock(core.getMutex());
+        moved = core.setBankInsertion(bank, insertionDepth);
+    }
+    if (!moved) {
+        std::cout << "Bank must be 0 to " << (core.getBankCount() - 1)
+                  << ", not tripped, and insertion depth between 0.0 and 1.0.\n";
+        return false;
+    }
+    if (options.verbose) {
+        std::cout << "Rod bank " << bank << " moving to " << (insertionDepth * 100) << "% insertion.\n";
+    }
+    return true;
 }
 
-void MainSimulation::initiateCasualty(const std::string& casualtyType) {
+bool MainSimulation::initiateCasualty(const std::string& casualty) {
+    // Coolant casualties take an optional trailing loop number ("leak 1"); loop 0 by default
+    std::string casualtyType = casualty;
+    int loop = 0;
+    std::size_t lastSpace = casualty.find_last_of(' ');
+    if (lastSpace != std::string::npos && lastSpace + 1 < casualty.size()
+        && std::isdigit(static_cast<unsigned char>(casualty[lastSpace + 1]))) {
+        loop = std::stoi(casualty.substr(lastSpace + 1));
+        casualtyType = casualty.substr(0, lastSpace);
+    }
+    if (loop >= coolantSystem.getLoopCount()) {
+        std::cout << "Coolant loop must be 0 to " << (coolantSystem.getLoopCount() - 1) << ".\n";
+        return false;
+    }
+
     if (casualtyType == "leak") {
         // Simulate a coolant leak
+        CoolantLoop& coolantLoop = coolantSystem.getLoop(loop);
+        std::lock_guard<std::mutex> lock(coolantLoop.getMutex());
         coolantLoop.setLeak(true);
-        std::cout << "Coolant leak initiated.\n";
+        if (options.verbose) {
+            std::cout << "Coolant leak initiated in loop " << loop << ".\n";
+        }
+    } else if (casualtyType == "pump trip") {
+        // Trip the loop's coolant pump; the flow coasts down
+        CoolantLoop& coolantLoop = coolantSystem.getLoop(loop);
+        std::lock_guard<std::mutex> lock(coolantLoop.getMutex());
+        coolantLoop.tripPump();
+        if (options.verbose) {
+            std::cout << "Coolant pump tripped in loop " << loop << ".\n";
+        }
+    } else if (casualtyType == "feedwater trip") {
+        // Trip the loop's feed pumps; its steam generator boils down and stops removing heat
+        CoolantLoop& coolantLoop = coolantSystem.getLoop(loop);
+        std::lock_guard<std::mutex> lock(coolantLoop.getMutex());
+        coolantLoop.getSteamGenerator().tripFeedwater();
+        if (options.verbose) {
+            std::cout << "Feedwater tripped in loop " << loop << ".\n";
+        }
     } else if (casualtyType == "power surge") {
         // Simulate a sudden increase in reactivity
+        std::lock_guard<std::mutex> lock(core.getMutex());
         core.increaseReactivity(0.1); // Increase by 10%
-        std::cout << "Power surge initiated.\n";
+        if (options.verbose) {
+            std::cout << "Power surge initiated.\n";
+        }
     } else {
         std::cout << "Unknown casualty type.\n";
+        return false;
     }
+    return true;
 }
 
-double MainSimulation::getMaxCoreTemperature() const {
-    double maxTemperature = 0.0;
+bool MainSimulation::rewindTo(double targetTime) {
+    double restoredTime = 0.0;
+    bool scramInitiated = false;
 
-    const auto& elements = core.getElements();
+    if (!history || !history->rewind(targetTime, core, coolantSystem, restoredTime, scramInitiated)) {
+        std::lock_guard<std::mutex> lock(ioMutex);
+        std::cout << "No session history available to rewind.\n";
+        return false;
+    }
 
-#pragma omp parallel for reduction(max:maxTemperature)
-    for (size_t i = 0; i < elements.size(); ++i) {
-        double temp = elements[i].getTemperature();
-        if (temp > maxTemperature) {
-            maxTemperature = temp;
-        }
+    const double issuedAt = simTime;
+    simTime = restoredTime;
+    protectiveLogic.setScramInitiated(scramInitiated);
+    if (scenario.isLoaded()) {
+        scenario.rewindTo(simTime, issuedAt);
+    }
+
+    if (options.verbose) {
+        std::lock_guard<std::mutex> lock(ioMutex);
+        std::cout << "Rewound to t = " << simTime << " s.\n";
     }
+    return true;
+}
+
+double MainSimulation::getMaxCoreTemperature() const {
+    const auto& elements = core.getElements();
 
-    return maxTemperature;
+    return deterministicMax(elements.size(), [&](std::size_t i) {
+        return elements[i].getTemperature();
+    }, 0.0);
 }
 
 void MainSimulation::handleUserInput() {
@@ -247,22 +610,46 @@ void MainSimulation::handleUserInput() {
                 std::lock_guard<std::mutex> lock(ioMutex);
                 std::cout << "Available commands:\n"
                           << " - adjust rods [depth]: Adjust control rod insertion depth (0.0 to 1.0)\n"
-                          << " - initiate casualty [type]: Initiate a casualty ('leak', 'power surge')\n"
+                          << " - adjust bank [bank] [depth]: Move one rod bank to an insertion depth\n"
+                          << " - initiate casualty [type]: Initiate a casualty ('leak', 'pump trip', 'feedwater trip', 'power surge')\n"
+                          << " - initiate casualty [type] [loop]: Leak, pump or feedwater trip in one coolant loop (default 0)\n"
+                          << " - rewind [seconds]: Rewind the simulation and continue from that point\n"
                           << " - exit: Stop the simulation\n";
             } else if (command.find("adjust rods") == 0) {
-                // Extract depth value
-                double depth = 0.0;
+                // Validate the depth here; the command itself is applied between steps
                 try {
-                    depth = std::stod(command.substr(12));
-                    adjustControlRods(depth);
+                    std::stod(command.substr(12));
+                    submitCommand(command);
                 } catch (...) {
                     std::lock_guard<std::mutex> lock(ioMutex);
                     std::cout << "Invalid depth value.\n";
                 }
+            } else if (command.find("adjust bank") == 0) {
+                // Bank and depth ranges are checked when the command is applied
+                std::istringstream arguments(command.substr(11));
+                int bank = 0;
+                double depth = 0.0;
+                if (arguments >> bank >> depth) {
+                    submitCommand(command);
+                } else {
+                    std::lock_guard<std::mutex> lock(ioMutex);
+                    std::cout << "Usage: adjust bank [bank] [depth]\n";
+                }
             } else if (command.find("initiate casualty") == 0) {
-                // Extract casualty type
-                std::string casualtyType = command.substr(18);
-                initiateCasualty(casualtyType);
+                // Casualty type is checked when the command is applied
+                submitCommand(command);
+            } else if (command.find("rewind") == 0) {
+                // Validate number of seconds to rewind
+                try {
+                    double seconds = std::stod(command.substr(7));
+                    if (seconds <= 0.0) {
+                        throw std::invalid_argument("seconds");
+                    }
+                    submitCommand(command);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(ioMutex);
+                    std::cout << "Invalid rewind duration.\n";
+                }
             } else if (command == "exit") {
                 running.store(false);
             } else if (command == "pause") {
@@ -295,11 +682,8 @@ void MainSimulation::handleUserInput() {
 void MainSimulation::updateDisplay() {
     // For now, output key parameters to the console
     std::lock_guard<std::mutex> lock(ioMutex);
-    double maxTemperature = getMaxCoreTemperature();
-    double upperCoolantTemp = coolantLoop.getUpperChunk().getTemperature();
-    double lowerCoolantTemp = coolantLoop.getLowerChunk().getTemperature();
 
-    //std::cout << "Max Core Temperature: " << maxTemperature << " K"
-    //          << ", Upper Coolant Temp: " << upperCoolantTemp << " K"
-    //          << ", Lower Coolant Temp: " << lowerCoolantTemp << " K" << std::endl;
+    //std::cout << "Max Core Temperature: " << telemetry.maxCoreTemperature << " K"
+    //          << ", Upper Coolant Temp: " << telemetry.upperCoolantTemperature << " K"
+    //          << ", Lower Coolant Temp: " << telemetry.lowerCoolantTemperature << " K" << std::endl;
 }
\ No newline at end of file
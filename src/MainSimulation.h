@@ -6,26 +6,122 @@
 #define MAINSIMULATION_H
 
 class Core;
+class WorkerPool;
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
 
-#include "CoolantLoop.h"
+#include "CommandJournal.h"
+#include "CoolantChannels.h"
+#include "CoolantSystem.h"
+#include "HeatConduction.h"
+#include "PlantTelemetry.h"
 #include "ProtectiveActionLogic.h"
-#include "Visualization.h"
-
+#include "ScenarioEngine.h"
+#include "SessionHistory.h"
+#include "TelemetryRecorder.h"
+
+struct SimulationOptions {
+    bool interactive = true;     // Read operator commands from stdin on an input thread
+    double fixedTimeStep = 0.0;  // Seconds; when > 0 every step uses it instead of the measured wall-clock time
+    std::string journalPath;     // Record operator commands for replay (implies a fixed time step)
+    std::string scenarioPath;    // Scripted events; the run stops at the scenario's end time
+    bool realTime = true;        // Throttle steps to wall-clock time (false implies a fixed time step)
+    bool keepHistory = true;     // Keep a rewind buffer (one encoder thread per simulation)
+    bool externalCorePhysics = false; // The driver advances the Core kernels itself (BatchedCore)
+    bool verbose = true;         // Print scram, scenario and command confirmations
+    WorkerPool* workerPool = nullptr; // Steps loops and conduction lines in parallel; null steps them in turn
+
+    // Multi-rate integration: each physics component runs at its natural step. Flux is
+    // subcycled within a step, thermals and rods run once per step, burnup/xenon only
+    // integrate flux per step and deplete every burnupInterval seconds, and conduction through
+    // the core (time constant of tens of minutes) covers a whole conductionInterval at once
+    // each time the simulated time passes a multiple of it.
+    int fluxSubsteps = 1;
+    double burnupInterval = 10.0;    // 0 = deplete every step
+    double conductionInterval = 1.0; // 0 = conduct every step
+
+    // Drive the core with point kinetics (Core::calculatePointKinetics) instead of the
+    // spatial flux and thermal kernels: far cheaper, for small machines and large ensembles
+    bool pointKinetics = false;
+
+    // Error-controlled stepping. The flux takes step-doubling checked substeps in place of
+    // fluxSubsteps. Unthrottled runs without a journal or external core physics also size
+    // the step itself from an embedded estimate of the thermal error, between minTimeStep
+    // and maxTimeStep, and stay at or below fixedTimeStep while rods are moving.
+    bool adaptiveStep = false;
+    double stepTolerance = 1e-3; // Relative error allowed per step
+    double minTimeStep = 0.005;
+    double maxTimeStep = 0.5;
+};
 
 class MainSimulation {
 public:
-    MainSimulation(Core &core, CoolantLoop &coolantLoop, std::atomic<bool> &running);
+    MainSimulation(Core &core, CoolantSystem &coolantSystem, std::atomic<bool> &running,
+                   const SimulationOptions& options = SimulationOptions());
     ~MainSimulation();
 
     void runSimulation();
 
+    // Applies queued commands and advances one step; for drivers that schedule steps themselves
+    void step();
+
+    // step() split around the Core kernels, for drivers using externalCorePhysics:
+    // beginStep(), advance the Core by the fixed time step, then finishStep()
+    void beginStep();
+    void finishStep();
+
+    // Re-runs a journaled session unthrottled. Returns true if the final state hash matches.
+    bool replay(const CommandJournal& journal);
+
+    // Queue an operator command; it takes effect at the start of the next step
+    void submitCommand(const std::string& command);
+
+    // Must be called before runSimulation
+    bool enableRecording(const RecorderConfig& config);
+
+    // Latest values published by the simulation thread
+    [[nodiscard]] PlantTelemetry getTelemetry() const;
+
+    [[nodiscard]] double getTimeStep() const { return deltaTime; }
+    [[nodiscard]] std::uint64_t getFluxSubstepCount() const { return fluxSubstepCount; }
+
 private:
     Core& core;
-    CoolantLoop& coolantLoop;
+    CoolantSystem& coolantSystem;
+    CoolantChannels coolantChannels;
+    HeatConduction heatConduction;
     ProtectiveActionLogic protectiveLogic;
+    SimulationOptions options;
     double deltaTime{}; // Time step in seconds
+    double simTime{};   // Simulated time since start in seconds
+    std::uint64_t stepCount{};
+
+    // Adaptive stepping state
+    double fluxStep{};                    // Flux controller's step size
+    double previousMaxTemperature{-1.0};  // Below zero until the first step
+    double previousTemperatureRate{};
+    double previousOutletTemperature{-1.0};
+    double previousOutletRate{};
+    std::uint64_t fluxSubstepCount{};
+
+    // Computed once per step in iterate()
+    PlantTelemetry telemetry;
+    PlantTelemetry publishedTelemetry;
+    mutable std::mutex telemetryMutex;
+    std::unique_ptr<TelemetryRecorder> recorder;
+
+    // Rewind buffer
+    std::unique_ptr<SessionHistory> history;
+
+    // Operator commands are applied between steps and journaled with the step number
+    std::vector<std::string> pendingCommands;
+    std::mutex commandMutex;
+    CommandJournal journal;
+    ScenarioEngine scenario;
 
     // User input thread
     std::thread inputThread;
@@ -35,21 +131,26 @@ private:
 
 
     void iterate();
+    void stepOnce();
+
+    void applyPendingCommands();
+    std::string applyCommand(const std::string& command);
 
     void displayStatus() const;
 
-    void exchangeHeat();
+    double exchangeHeat(double& heatTransferred); // Returns the power generated
 
     void handleUserInput();
     void updateDisplay();
 
-    double calculateHeatTransferCoefficient(double density, double heatCapacity) const;
-
-    void evaluateProtection();
+    void evaluateProtection(double maxCoreTemperature);
+    void chooseNextTimeStep();
 
     // New methods for user interactions
-    void adjustControlRods(double insertionDepth) const;
-    void initiateCasualty(const std::string& casualtyType);
+    bool adjustControlRods(double insertionDepth) const;
+    bool adjustRodBank(int bank, double insertionDepth) const;
+    bool initiateCasualty(const std::string& casualty);
+    bool rewindTo(double targetTime);
 
     [[nodiscard]] double getMaxCoreTemperature() const;
 
@@ -0,0 +1,398 @@
+// ParameterSweep.cpp
+
+#include "ParameterSweep.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+
+#include "Core.h"
+#include "CoolantSystem.h"
+#include "MainSimulation.h"
+#include "WorkerPool.h"
+
+bool ParameterSweep::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Failed to open sweep " << path << std::endl;
+        return false;
+    }
+
+    axes.clear();
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+
+        std::istringstream fields(line);
+        std::string directive;
+        fields >> directive;
+        if (directive.empty() || directive[0] == '#') {
+            continue;
+        }
+
+        bool valid = false;
+        if (directive == "duration") {
+            valid = static_cast<bool>(fields >> duration) && duration > 0.0;
+        } else if (directive == "time-step") {
+            valid = static_cast<bool>(fields >> timeStep) && timeStep > 0.0;
+        } else if (directive == "adaptive-step") {
+            valid = static_cast<bool>(fields >> stepTolerance) && stepTolerance > 0.0;
+        } else if (directive == "point-kinetics") {
+            pointKinetics = true;
+            valid = true;
+        } else if (directive == "size") {
+            valid = static_cast<bool>(fields >> coreSize) && coreSize >= 3;
+        } else if (directive == "chunks") {
+            valid = static_cast<bool>(fields >> coolantChunks) && coolantChunks > 0;
+        } else if (directive == "loops") {
+            valid = static_cast<bool>(fields >> coolantLoops) && coolantLoops > 0;
+        } else if (directive == "post-scram") {
+            valid = static_cast<bool>(fields >> postScram) && postScram >= 0.0;
+        } else if (directive == "scenario") {
+            valid = static_cast<bool>(fields >> scenarioPath);
+        } else if (directive == "samples") {
+            valid = static_cast<bool>(fields >> samples) && samples > 0;
+        } else if (directive == "seed") {
+            valid = static_cast<bool>(fields >> seed);
+        } else if (directive == "param") {
+            Axis axis{};
+            std::string name, kind;
+            fields >> name >> kind;
+            valid = !fields.fail() && parseParameter(name, axis.parameter);
+
+            if (valid && kind == "values") {
+                axis.kind = Kind::Values;
+                double value;
+                while (fields >> value) {
+                    axis.values.push_back(value);
+                }
+                valid = !axis.values.empty();
+            } else if (valid && kind == "range") {
+                axis.kind = Kind::Values;
+                double from, to;
+                int count;
+                valid = static_cast<bool>(fields >> from >> to >> count) && count > 0;
+                for (int i = 0; valid && i < count; ++i) {
+                    axis.values.push_back(count == 1 ? from : from + (to - from) * i / (count - 1));
+                }
+            } else if (valid && (kind == "uniform" || kind == "normal")) {
+                axis.kind = kind == "uniform" ? Kind::Uniform : Kind::Normal;
+                double a, b;
+                valid = static_cast<bool>(fields >> a >> b) && (kind == "uniform" ? a <= b : b >= 0.0);
+                axis.values = {a, b};
+            } else {
+                valid = false;
+            }
+
+            if (valid) {
+                axes.push_back(axis);
+            }
+        }
+
+        if (!valid) {
+            std::cerr << path << ":" << lineNumber << ": invalid sweep line: " << line << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::size_t ParameterSweep::gridPointCount() const {
+    std::size_t count = 1;
+    for (const auto& axis : axes) {
+        if (axis.kind == Kind::Values) {
+            count *= axis.values.size();
+        }
+    }
+    return count;
+}
+
+std::vector<std::string> ParameterSweep::getParameterNames() const {
+    std::vector<std::string> names;
+    for (const auto& axis : axes) {
+        names.emplace_back(getParameterName(axis.parameter));
+    }
+    return names;
+}
+
+std::vector<double> ParameterSweep::drawParameters(std::size_t run) const {
+    // Each run owns its random stream, so results do not depend on scheduling
+    std::seed_seq seedSequence{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32),
+                               static_cast<std::uint32_t>(run), static_cast<std::uint32_t>(run >> 32)};
+    std::mt19937_64 generator(seedSequence);
+
+    std::size_t gridIndex = run / samples;
+    std::vector<double> values;
+    for (const auto& axis : axes) {
+        switch (axis.kind) {
+            case Kind::Values:
+                values.push_back(axis.values[gridIndex % axis.values.size()]);
+                gridIndex /= axis.values.size();
+                break;
+            case Kind::Uniform:
+                values.push_back(std::uniform_real_distribution<double>(axis.values[0], axis.values[1])(generator));
+                break;
+            case Kind::Normal:
+                values.push_back(std::normal_distribution<double>(axis.values[0], axis.values[1])(generator));
+                break;
+        }
+    }
+    return values;
+}
+
+ParameterSweep::RunResult ParameterSweep::runOne(std::size_t run) const {
+    RunResult result{};
+    result.gridPoint = run / samples;
+    result.parameters = drawParameters(run);
+    result.timeToScram = -1.0;
+
+    Core core(coreSize, coreSize, coreSize);
+    CoolantSystem coolantSystem(coolantLoops, coolantChunks);
+    for (std::size_t i = 0; i < axes.size(); ++i) {
+        applyParameter(axes[i].parameter, result.parameters[i], core, coolantSystem);
+    }
+
+    SimulationOptions options;
+    options.interactive = false;
+    options.realTime = false;
+    options.fixedTimeStep = timeStep;
+    options.keepHistory = false;
+    options.verbose = false;
+    options.scenarioPath = scenarioPath;
+    options.pointKinetics = pointKinetics;
+    options.adaptiveStep = stepTolerance > 0.0;
+    if (options.adaptiveStep) {
+        options.stepTolerance = stepTolerance;
+    }
+
+    std::atomic<bool> running(true);
+    MainSimulation simulation(core, coolantSystem, running, options);
+
+    double stopTime = duration;
+    PlantTelemetry telemetry{};
+    while (running.load() && telemetry.simTime < stopTime) {
+        simulation.step();
+        ++result.steps;
+        telemetry = simulation.getTelemetry();
+        result.peakTemperature = std::max(result.peakTemperature, telemetry.maxCoreTemperature);
+
+        if (telemetry.scramInitiated && !result.scrammed) {
+            result.scrammed = true;
+            result.timeToScram = telemetry.simTime;
+            stopTime = std::min(duration, telemetry.simTime + postScram);
+        }
+    }
+    result.endTime = telemetry.simTime;
+    return result;
+}
+
+void ParameterSweep::run(std::size_t threadCount) {
+    const std::size_t runCount = getRunCount();
+    results.assign(runCount, RunResult{});
+
+    WorkerPool pool(threadCount);
+    std::cout << "Running " << runCount << " simulations (" << gridPointCount() << " grid points x "
+              << samples << " samples) on " << pool.getThreadCount() << " threads." << std::endl;
+
+    std::atomic<std::size_t> completed(0);
+    std::mutex progressMutex;
+    auto start = std::chrono::steady_clock::now();
+
+    pool.parallelFor(runCount, [&](std::size_t run) {
+        results[run] = runOne(run);
+
+        std::size_t done = completed.fetch_add(1) + 1;
+        if (done % std::max<std::size_t>(1, runCount / 10) == 0 || done == runCount) {
+            std::lock_guard<std::mutex> lock(progressMutex);
+            std::cout << "  " << done << "/" << runCount << " done" << std::endl;
+        }
+    });
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << runCount << " simulations in " << elapsed.count() << " s ("
+              << runCount / elapsed.count() * 3600.0 << " simulations/hour)" << std::endl;
+}
+
+bool ParameterSweep::writeRuns(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Failed to open " << path << std::endl;
+        return false;
+    }
+
+    out << "run,gridPoint";
+    for (const auto& name : getParameterNames()) {
+        out << "," << name;
+    }
+    out << ",scrammed,timeToScram,peakTemperature,endTime,steps\n";
+
+    out << std::setprecision(10);
+    for (std::size_t run = 0; run < results.size(); ++run) {
+        const RunResult& result = results[run];
+        out << run << "," << result.gridPoint;
+        for (double value : result.parameters) {
+            out << "," << value;
+        }
+        out << "," << (result.scrammed ? 1 : 0) << "," << result.timeToScram << ","
+            << result.peakTemperature << "," << result.endTime << "," << result.steps << "\n";
+    }
+    return true;
+}
+
+namespace {
+
+struct Summary {
+    std::size_t runs = 0;
+    std::size_t scrams = 0;
+    double scramTimeMean = 0.0, scramTimeM2 = 0.0; // Welford running moments
+    double minScramTime = 0.0, maxScramTime = 0.0;
+    double peakSum = 0.0, maxPeak = 0.0;
+
+    void add(const ParameterSweep::RunResult& result) {
+        ++runs;
+        peakSum += result.peakTemperature;
+        maxPeak = std::max(maxPeak, result.peakTemperature);
+        if (result.scrammed) {
+            minScramTime = scrams == 0 ? result.timeToScram : std::min(minScramTime, result.timeToScram);
+            maxScramTime = scrams == 0 ? result.timeToScram : std::max(maxScramTime, result.timeToScram);
+            ++scrams;
+            double delta = result.timeToScram - scramTimeMean;
+            scramTimeMean += delta / scrams;
+            scramTimeM2 += delta * (result.timeToScram - scramTimeMean);
+        }
+    }
+
+    [[nodiscard]] double meanScramTime() const { return scramTimeMean; }
+    [[nodiscard]] double stddevScramTime() const { return scrams < 2 ? 0.0 : std::sqrt(scramTimeM2 / (scrams - 1)); }
+};
+
+std::vector<Summary> summarize(const std::vector<ParameterSweep::RunResult>& results, std::size_t gridPoints) {
+    std::vector<Summary> summaries(gridPoints);
+    for (const auto& result : results) {
+        summaries[result.gridPoint].add(result);
+    }
+    return summaries;
+}
+
+} // namespace
+
+bool ParameterSweep::writeSummary(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Failed to open " << path << std::endl;
+        return false;
+    }
+
+    // Grid-axis values identify each row; drawn parameters vary within it
+    out << "gridPoint";
+    for (const auto& axis : axes) {
+        if (axis.kind == Kind::Values) {
+            out << "," << getParameterName(axis.parameter);
+        }
+    }
+    out << ",runs,scrams,scramFraction,meanTimeToScram,stddevTimeToScram,minTimeToScram,maxTimeToScram,"
+           "meanPeakTemperature,maxPeakTemperature\n";
+
+    out << std::setprecision(10);
+    std::vector<Summary> summaries = summarize(results, gridPointCount());
+    for (std::size_t point = 0; point < summaries.size(); ++point) {
+        const Summary& summary = summaries[point];
+        if (summary.runs == 0) {
+            continue;
+        }
+
+        out << point;
+        const RunResult& first = results[point * samples];
+        for (std::size_t i = 0; i < axes.size(); ++i) {
+            if (axes[i].kind == Kind::Values) {
+                out << "," << first.parameters[i];
+            }
+        }
+        out << "," << summary.runs << "," << summary.scrams << ","
+            << static_cast<double>(summary.scrams) / summary.runs << "," << summary.meanScramTime() << ","
+            << summary.stddevScramTime() << "," << summary.minScramTime << "," << summary.maxScramTime << ","
+            << summary.peakSum / summary.runs << "," << summary.maxPeak << "\n";
+    }
+    return true;
+}
+
+void ParameterSweep::printSummary() const {
+    std::vector<Summary> summaries = summarize(results, gridPointCount());
+
+    std::cout << "point";
+    for (const auto& axis : axes) {
+        if (axis.kind == Kind::Values) {
+            std::cout << "  " << getParameterName(axis.parameter);
+        }
+    }
+    std::cout << "  runs  scram%  timeToScram[s] (mean +- sd)  peakTemp[K] (mean/max)\n";
+
+    for (std::size_t point = 0; point < summaries.size(); ++point) {
+        const Summary& summary = summaries[point];
+        if (summary.runs == 0) {
+            continue;
+        }
+
+        std::cout << point;
+        const RunResult& first = results[point * samples];
+        for (std::size_t i = 0; i < axes.size(); ++i) {
+            if (axes[i].kind == Kind::Values) {
+                std::cout << "  " << first.parameters[i];
+            }
+        }
+        std::cout << "  " << summary.runs << "  " << 100.0 * summary.scrams / summary.runs << "  "
+                  << summary.meanScramTime() << " +- " << summary.stddevScramTime() << "  "
+                  << summary.peakSum / summary.runs << "/" << summary.maxPeak << "\n";
+    }
+}
+
+bool ParameterSweep::parseParameter(const std::string& name, Parameter& parameter) {
+    for (Parameter candidate : {Parameter::TemperatureCoefficient, Parameter::VoidCoefficient, Parameter::HeatLoss,
+                                Parameter::FeedwaterFlow, Parameter::U235Loading}) {
+        if (name == getParameterName(candidate)) {
+            parameter = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* ParameterSweep::getParameterName(Parameter parameter) {
+    switch (parameter) {
+        case Parameter::TemperatureCoefficient: return "temperature-coefficient";
+        case Parameter::VoidCoefficient: return "void-coefficient";
+        case Parameter::HeatLoss: return "heat-loss";
+        case Parameter::FeedwaterFlow: return "feedwater-flow";
+        case Parameter::U235Loading: return "u235-loading";
+    }
+    return "unknown";
+}
+
+void ParameterSweep::applyParameter(Parameter parameter, double value, Core& core, CoolantSystem& coolantSystem) {
+    switch (parameter) {
+        case Parameter::TemperatureCoefficient:
+            core.setTemperatureCoefficient(value);
+            break;
+        case Parameter::VoidCoefficient:
+            core.setVoidCoefficient(value);
+            break;
+        case Parameter::HeatLoss:
+            coolantSystem.setHeatLossRate(value);
+            break;
+        case Parameter::FeedwaterFlow:
+            coolantSystem.setFeedwaterFlowRate(value);
+            break;
+        case Parameter::U235Loading:
+            core.setU235Loading(value);
+            break;
+    }
+}
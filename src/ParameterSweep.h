@@ -0,0 +1,105 @@
+// ParameterSweep.h
+
+#ifndef PARAMETERSWEEP_H
+#define PARAMETERSWEEP_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Core;
+class CoolantSystem;
+
+// Runs many unthrottled, headless simulations over a grid of plant parameters and/or Monte
+// Carlo draws, and aggregates trip outcomes. A sweep file is a list of directives:
+//
+//   # comment
+//   duration <seconds>          Simulated time per run (default 120)
+//   time-step <seconds>         Fixed step (default 0.033)
+//   adaptive-step <tolerance>   Error-controlled steps instead, starting from time-step
+//   point-kinetics              Point-kinetics cores instead of the spatial solver
+//   size <n>                    Core is n x n x n (default 10)
+//   chunks <n>                  Coolant chunks per loop (default 100)
+//   loops <n>                   Coolant loops (default 1)
+//   post-scram <seconds>        Keep running this long after the trip (default 0: stop at scram)
+//   scenario <path>             Scenario script run by every simulation
+//   samples <n>                 Monte Carlo draws per grid point (default 1)
+//   seed <n>                    Base seed; run i always draws from the same stream
+//   param <name> values <v>...              Grid axis with the listed values
+//   param <name> range <from> <to> <count>  Grid axis with evenly spaced values
+//   param <name> uniform <low> <high>       Drawn per run
+//   param <name> normal <mean> <stddev>     Drawn per run
+//
+// <name> is one of temperature-coefficient, void-coefficient, heat-loss (ambient, J/s per coolant
+// chunk), feedwater-flow (kg/s per steam generator), u235-loading.
+// Grid axes combine as a Cartesian product; each grid point is run <samples> times with fresh
+// draws.
+class ParameterSweep {
+public:
+    struct RunResult {
+        std::size_t gridPoint;
+        std::vector<double> parameters; // Same order as getParameterNames()
+        bool scrammed;
+        double timeToScram;     // Seconds; -1 if the run never tripped
+        double peakTemperature; // Maximum core temperature over the run [K]
+        double endTime;
+        std::uint64_t steps;
+    };
+
+    bool load(const std::string& path);
+
+    // Runs every simulation on threadCount threads (0 = all hardware threads)
+    void run(std::size_t threadCount);
+
+    bool writeRuns(const std::string& path) const;
+    bool writeSummary(const std::string& path) const;
+    void printSummary() const;
+
+    [[nodiscard]] std::size_t getRunCount() const { return gridPointCount() * samples; }
+    [[nodiscard]] std::vector<std::string> getParameterNames() const;
+    [[nodiscard]] const std::vector<RunResult>& getResults() const { return results; }
+
+private:
+    enum class Parameter {
+        TemperatureCoefficient,
+        VoidCoefficient,
+        HeatLoss,
+        FeedwaterFlow,
+        U235Loading
+    };
+    enum class Kind {
+        Values,
+        Uniform,
+        Normal
+    };
+    struct Axis {
+        Parameter parameter;
+        Kind kind;
+        std::vector<double> values; // Grid values, or the two distribution arguments
+    };
+
+    double duration = 120.0;
+    double timeStep = 0.033;
+    double stepTolerance = 0.0; // > 0 enables adaptive steps
+    bool pointKinetics = false;
+    int coreSize = 10;
+    int coolantChunks = 100;
+    int coolantLoops = 1;
+    double postScram = 0.0;
+    std::string scenarioPath;
+    std::size_t samples = 1;
+    std::uint64_t seed = 1;
+    std::vector<Axis> axes;
+
+    std::vector<RunResult> results;
+
+    [[nodiscard]] std::size_t gridPointCount() const;
+    [[nodiscard]] std::vector<double> drawParameters(std::size_t run) const;
+    [[nodiscard]] RunResult runOne(std::size_t run) const;
+
+    static bool parseParameter(const std::string& name, Parameter& parameter);
+    static const char* getParameterName(Parameter parameter);
+    static void applyParameter(Parameter parameter, double value, Core& core, CoolantSystem& coolantSystem);
+};
+
+#endif // PARAMETERSWEEP_H
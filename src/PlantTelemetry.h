@@ -0,0 +1,27 @@
+// PlantTelemetry.h
+
+#ifndef PLANTTELEMETRY_H
+#define PLANTTELEMETRY_H
+
+#include <cstdint>
+
+// Plant-level values computed once per simulation step and published for
+// display, recording and other consumers that should not rescan the Core.
+struct PlantTelemetry {
+    std::uint64_t step = 0;
+    double simTime = 0.0;                  // s
+    double maxCoreTemperature = 0.0;       // K
+    double totalPower = 0.0;               // Heat generated in fuel this step (arbitrary units)
+    double upperCoolantTemperature = 0.0;  // K, core outlet, flow-weighted over the loops
+    double lowerCoolantTemperature = 0.0;  // K, core inlet (plenum), flow-weighted over the loops
+    double controlRodInsertion = 0.0;      // 0.0 to 1.0
+    bool scramInitiated = false;
+    double coolantFlowRate = 0.0;          // kg/s, all loops
+    double hotChannelTemperature = 0.0;    // K, hottest coolant channel outlet
+    double coreVoidFraction = 0.0;         // Mean coolant void beside the fuel
+    double steamPower = 0.0;               // W, all steam generators
+    double coolantInventory = 0.0;         // kg, all loops
+    double pressurizerLevel = 0.0;         // 0.0 to 1.0, mean over the loops
+};
+
+#endif // PLANTTELEMETRY_H
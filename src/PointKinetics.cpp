@@ -0,0 +1,113 @@
+// PointKinetics.cpp
+
+#include "PointKinetics.h"
+#include <algorithm>
+#include <cmath>
+
+double PointKineticsParameters::totalBeta() const {
+    double sum = 0.0;
+    for (double b : beta) {
+        sum += b;
+    }
+    return sum;
+}
+
+PointKinetics::PointKinetics(const PointKineticsParameters& parameters) : parameters(parameters) {
+    reset(1.0);
+}
+
+void PointKinetics::setParameters(const PointKineticsParameters& newParameters) {
+    parameters = newParameters;
+    reset(getPower());
+}
+
+void PointKinetics::reset(double power) {
+    state[0] = power;
+    for (int i = 0; i < delayedGroupCount; ++i) {
+        state[1 + i] = parameters.beta[i] * power / (parameters.lambda[i] * parameters.generationTime);
+    }
+}
+
+void PointKinetics::advance(double reactivity, double deltaTime) {
+    const double inverseLambda = 1.0 / parameters.generationTime;
+
+    Matrix a{};
+    a[0][0] = (reactivity - parameters.totalBeta()) * inverseLambda * deltaTime;
+    for (int i = 0; i < delayedGroupCount; ++i) {
+        a[0][1 + i] = parameters.lambda[i] * deltaTime;
+        a[1 + i][0] = parameters.beta[i] * inverseLambda * deltaTime;
+        a[1 + i][1 + i] = -parameters.lambda[i] * deltaTime;
+    }
+
+    Matrix propagator = exponential(a);
+
+    std::array<double, stateSize> next{};
+    for (std::size_t r = 0; r < stateSize; ++r) {
+        for (std::size_t c = 0; c < stateSize; ++c) {
+            next[r] += propagator[r][c] * state[c];
+        }
+    }
+    state = next;
+}
+
+PointKinetics::Matrix PointKinetics::multiply(const Matrix& a, const Matrix& b) {
+    Matrix product{};
+    for (std::size_t r = 0; r < stateSize; ++r) {
+        for (std::size_t k = 0; k < stateSize; ++k) {
+            for (std::size_t c = 0; c < stateSize; ++c) {
+                product[r][c] += a[r][k] * b[k][c];
+            }
+        }
+    }
+    return product;
+}
+
+PointKinetics::Matrix PointKinetics::exponential(const Matrix& a) {
+    // Scale until the norm is below 1/2, sum the Taylor series, then square back up
+    double norm = 0.0;
+    for (const auto& row : a) {
+        double rowSum = 0.0;
+        for (double value : row) {
+            rowSum += std::abs(value);
+        }
+        norm = std::max(norm, rowSum);
+    }
+    int squarings = norm > 0.5 ? static_cast<int>(std::ceil(std::log2(norm / 0.5))) : 0;
+    double scale = std::ldexp(1.0, -squarings);
+
+    Matrix scaled = a;
+    for (auto& row : scaled) {
+        for (double& value : row) {
+            value *= scale;
+        }
+    }
+
+    Matrix result{};
+    Matrix term{};
+    for (std::size_t i = 0; i < stateSize; ++i) {
+        result[i][i] = 1.0;
+        term[i][i] = 1.0;
+    }
+    for (int k = 1; k <= 12; ++k) {
+        term = multiply(term, scaled);
+        for (std::size_t r = 0; r < stateSize; ++r) {
+            for (std::size_t c = 0; c < stateSize; ++c) {
+                term[r][c] /= k;
+                result[r][c] += term[r][c];
+            }
+        }
+    }
+
+    for (int s = 0; s < squarings; ++s) {
+        result = multiply(result, result);
+    }
+    return result;
+}
+
+void PointKinetics::writeState(double* out) const {
+    std::copy(state.begin(), state.end(), out);
+}
+
+void PointKinetics::readState(const double* in) {
+    std::copy(in, in + stateSize, state.begin());
+}
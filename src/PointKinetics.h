@@ -0,0 +1,59 @@
+// PointKinetics.h
+
+#ifndef POINTKINETICS_H
+#define POINTKINETICS_H
+
+#include <array>
+#include <cstddef>
+
+constexpr int delayedGroupCount = 6;
+
+// Six-group U-235 delayed-neutron data. The generation time defaults to one 33 ms frame, the
+// prompt time scale of the spatial model's per-step population update, so both core models
+// respond alike; set 1e-5 to 1e-4 s for a physical light-water core.
+struct PointKineticsParameters {
+    std::array<double, delayedGroupCount> beta = { 0.000215, 0.001424, 0.001274, 0.002568, 0.000748, 0.000273 };
+    std::array<double, delayedGroupCount> lambda = { 0.0124, 0.0305, 0.111, 0.301, 1.14, 3.01 }; // 1/s
+    double generationTime = 0.033; // s
+
+    [[nodiscard]] double totalBeta() const;
+};
+
+// Point-reactor kinetics: relative power n and delayed-neutron precursors C_i,
+//
+//   dn/dt   = (rho - beta) / Lambda * n + sum_i lambda_i C_i
+//   dC_i/dt = beta_i / Lambda * n - lambda_i C_i
+//
+// Reactivity is held constant over a step, so the step is the exact solution exp(A h) y of
+// the linear system. The exponential is evaluated by scaling and squaring, which stays
+// stable however stiff the prompt term is compared to the step.
+class PointKinetics {
+public:
+    static constexpr std::size_t stateSize = 1 + delayedGroupCount;
+
+    explicit PointKinetics(const PointKineticsParameters& parameters = PointKineticsParameters());
+
+    // Sets the power and puts the precursors in equilibrium with it
+    void reset(double power);
+
+    void advance(double reactivity, double deltaTime);
+
+    [[nodiscard]] double getPower() const { return state[0]; }
+    [[nodiscard]] double getPrecursor(int group) const { return state[1 + group]; }
+    [[nodiscard]] const PointKineticsParameters& getParameters() const { return parameters; }
+    void setParameters(const PointKineticsParameters& parameters);
+
+    void writeState(double* out) const;
+    void readState(const double* in);
+
+private:
+    using Matrix = std::array<std::array<double, stateSize>, stateSize>;
+
+    PointKineticsParameters parameters;
+    std::array<double, stateSize> state{};
+
+    static Matrix multiply(const Matrix& a, const Matrix& b);
+    static Matrix exponential(const Matrix& a);
+};
+
+#endif // POINTKINETICS_H
@@ -0,0 +1,21 @@
+// Precision.h
+
+#ifndef PRECISION_H
+#define PRECISION_H
+
+// Storage precision policy for per-cell fields.
+//
+// Bulk fields (flux, temperature, reactivity, cross-sections) are stored as FieldReal, which
+// is float when built with RXTRAINER_FLOAT_FIELDS (CMake option of the same name) and double
+// otherwise. Arithmetic is always done in double: getters widen, setters round once on store.
+// Quantities that integrate small increments over long runs (burnup concentrations) and all
+// Core-wide reductions use AccumReal, which stays double in both builds.
+#ifdef RXTRAINER_FLOAT_FIELDS
+using FieldReal = float;
+#else
+using FieldReal = double;
+#endif
+
+using AccumReal = double;
+
+#endif // PRECISION_H
@@ -0,0 +1,289 @@
+// PrecisionValidation.cpp
+//
+// Checks a float-field build (RXTRAINER_FLOAT_FIELDS) against the double build.
+//
+//   PrecisionValidation --write trace.bin [--steps N] [--size S] [--field-every K]
+//   PrecisionValidation --compare trace.bin [--tolerance relative]
+//
+// --write runs a fixed headless session (rod moves and a power surge at set steps) and stores
+// every step's telemetry scalars plus the core temperature and flux fields every K steps.
+// --compare re-runs the session recorded in the trace with this build and reports, per
+// signal, the largest deviation from the trace. Write the trace with the double build and
+// compare with the float build. Exits 1 if any relative deviation exceeds the tolerance.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Core.h"
+#include "CoolantSystem.h"
+#include "MainSimulation.h"
+#include "Precision.h"
+#include "TelemetryFormat.h"
+
+namespace {
+
+constexpr char traceMagic[4] = {'R', 'X', 'P', 'V'};
+constexpr std::uint32_t traceVersion = 1;
+constexpr int scalarCount = static_cast<int>(ScalarSignal::Count);
+
+struct TraceHeader {
+    std::uint32_t fieldBytes; // sizeof(FieldReal) of the build that wrote the trace
+    std::int32_t size;
+    std::int32_t coolantChunks;
+    std::uint64_t steps;
+    std::uint32_t fieldEvery;
+    double timeStep;
+};
+
+// One traced step: telemetry scalars, plus fields on sampled steps
+struct TraceStep {
+    double scalars[scalarCount];
+    std::vector<double> temperature;
+    std::vector<double> flux; // [group][cell]
+};
+
+class Session {
+public:
+    explicit Session(const TraceHeader& header)
+        : header(header),
+          core(header.size, header.size, header.size),
+          coolantSystem(1, header.coolantChunks),
+          running(true),
+          simulation(core, coolantSystem, running, options(header)) {}
+
+    // Advances one step and fills in what the trace stores for it
+    void step(std::uint64_t index, TraceStep& out) {
+        // Fixed command schedule so both builds see the same inputs
+        if (index == header.steps / 4) {
+            simulation.submitCommand("adjust rods 0.3");
+        } else if (index == header.steps / 2) {
+            simulation.submitCommand("initiate casualty power surge");
+        } else if (index == 3 * header.steps / 4) {
+            simulation.submitCommand("adjust rods 0.0");
+        }
+
+        simulation.step();
+
+        PlantTelemetry telemetry = simulation.getTelemetry();
+        for (int s = 0; s < scalarCount; ++s) {
+            out.scalars[s] = getSignalValue(telemetry, static_cast<ScalarSignal>(s));
+        }
+
+        out.temperature.clear();
+        out.flux.clear();
+        if ((index + 1) % header.fieldEvery == 0) {
+            const auto& elements = core.getElements();
+            for (const auto& element : elements) {
+                out.temperature.push_back(element.getTemperature());
+            }
+            for (int g = 0; g < numEnergyGroups; ++g) {
+                for (const auto& element : elements) {
+                    out.flux.push_back(element.getNeutronFlux(g));
+                }
+            }
+        }
+    }
+
+private:
+    TraceHeader header;
+    Core core;
+    CoolantSystem coolantSystem;
+    std::atomic<bool> running;
+    MainSimulation simulation;
+
+    static SimulationOptions options(const TraceHeader& header) {
+        SimulationOptions options;
+        options.interactive = false;
+        options.realTime = false;
+        options.fixedTimeStep = header.timeStep;
+        options.keepHistory = false;
+        options.verbose = false;
+        return options;
+    }
+};
+
+template <typename T>
+void writeValue(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+bool readValues(std::ifstream& in, std::vector<double>& values, std::size_t count) {
+    values.resize(count);
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(values.data()),
+                                     static_cast<std::streamsize>(count * sizeof(double))));
+}
+
+bool writeTrace(const std::string& path, const TraceHeader& header) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        std::cerr << "Failed to open " << path << std::endl;
+        return false;
+    }
+
+    out.write(traceMagic, sizeof(traceMagic));
+    writeValue(out, traceVersion);
+    writeValue(out, header);
+
+    Session session(header);
+    TraceStep step;
+    for (std::uint64_t i = 0; i < header.steps; ++i) {
+        session.step(i, step);
+        out.write(reinterpret_cast<const char*>(step.scalars), sizeof(step.scalars));
+        out.write(reinterpret_cast<const char*>(step.temperature.data()),
+                  static_cast<std::streamsize>(step.temperature.size() * sizeof(double)));
+        out.write(reinterpret_cast<const char*>(step.flux.data()),
+                  static_cast<std::streamsize>(step.flux.size() * sizeof(double)));
+    }
+
+    std::cout << "Wrote " << header.steps << " steps with " << 8 * header.fieldBytes << "-bit fields to "
+              << path << std::endl;
+    return static_cast<bool>(out);
+}
+
+// Largest absolute deviation and the largest deviation relative to the signal's own scale
+struct Deviation {
+    double maxAbsolute = 0.0;
+    double scale = 0.0;
+    double sumSquares = 0.0, referenceSquares = 0.0;
+
+    void add(double value, double reference) {
+        double error = std::abs(value - reference);
+        maxAbsolute = std::max(maxAbsolute, error);
+        scale = std::max(scale, std::abs(reference));
+        sumSquares += error * error;
+        referenceSquares += reference * reference;
+    }
+
+    [[nodiscard]] double relative() const { return scale > 0.0 ? maxAbsolute / scale : maxAbsolute; }
+    [[nodiscard]] double relativeRms() const {
+        return referenceSquares > 0.0 ? std::sqrt(sumSquares / referenceSquares) : std::sqrt(sumSquares);
+    }
+};
+
+bool compareTrace(const std::string& path, double tolerance) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[4];
+    std::uint32_t version = 0;
+    TraceHeader header{};
+    if (!in || !in.read(magic, sizeof(magic)) || std::memcmp(magic, traceMagic, sizeof(magic)) != 0
+        || !readValue(in, version) || version != traceVersion || !readValue(in, header)) {
+        std::cerr << path << " is not a precision validation trace" << std::endl;
+        return false;
+    }
+
+    std::cout << "Comparing " << 8 * sizeof(FieldReal) << "-bit fields against the " << 8 * header.fieldBytes
+              << "-bit trace (" << header.steps << " steps, " << header.size << "^3 core)" << std::endl;
+
+    Session session(header);
+    TraceStep step;
+    double reference[scalarCount];
+    std::vector<double> referenceTemperature, referenceFlux;
+    Deviation scalarDeviation[scalarCount];
+    Deviation temperatureDeviation, fluxDeviation;
+    double scramTime = -1.0, referenceScramTime = -1.0;
+
+    for (std::uint64_t i = 0; i < header.steps; ++i) {
+        session.step(i, step);
+        if (!in.read(reinterpret_cast<char*>(reference), sizeof(reference))
+            || !readValues(in, referenceTemperature, step.temperature.size())
+            || !readValues(in, referenceFlux, step.flux.size())) {
+            std::cerr << path << " ends early at step " << i << std::endl;
+            return false;
+        }
+
+        for (int s = 0; s < scalarCount; ++s) {
+            scalarDeviation[s].add(step.scalars[s], reference[s]);
+        }
+        for (std::size_t c = 0; c < step.temperature.size(); ++c) {
+            temperatureDeviation.add(step.temperature[c], referenceTemperature[c]);
+        }
+        for (std::size_t c = 0; c < step.flux.size(); ++c) {
+            fluxDeviation.add(step.flux[c], referenceFlux[c]);
+        }
+
+        const int scram = static_cast<int>(ScalarSignal::ScramInitiated);
+        const int time = static_cast<int>(ScalarSignal::SimTime);
+        if (scramTime < 0.0 && step.scalars[scram] != 0.0) {
+            scramTime = step.scalars[time];
+        }
+        if (referenceScramTime < 0.0 && reference[scram] != 0.0) {
+            referenceScramTime = reference[time];
+        }
+    }
+
+    bool pass = true;
+    std::cout << "signal  maxAbsError  maxRelError  relRmsError\n";
+    auto report = [&](const char* name, const Deviation& deviation) {
+        bool ok = deviation.relative() <= tolerance;
+        pass = pass && ok;
+        std::cout << name << "  " << deviation.maxAbsolute << "  " << deviation.relative() << "  "
+                  << deviation.relativeRms() << (ok ? "" : "  EXCEEDS TOLERANCE") << "\n";
+    };
+    for (int s = 0; s < scalarCount; ++s) {
+        report(getSignalName(static_cast<ScalarSignal>(s)), scalarDeviation[s]);
+    }
+    report("coreTemperature field", temperatureDeviation);
+    report("neutronFlux field", fluxDeviation);
+
+    std::cout << "Scram at " << scramTime << " s (trace: " << referenceScramTime << " s)\n"
+              << (pass ? "PASS" : "FAIL") << " at relative tolerance " << tolerance << std::endl;
+    return pass;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string writePath, comparePath;
+    TraceHeader header{};
+    header.fieldBytes = sizeof(FieldReal);
+    header.size = 10;
+    header.coolantChunks = 100;
+    header.steps = 1800;
+    header.fieldEvery = 30;
+    header.timeStep = 0.033;
+    double tolerance = 1e-4;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--write" && i + 1 < argc) {
+            writePath = argv[++i];
+        } else if (arg == "--compare" && i + 1 < argc) {
+            comparePath = argv[++i];
+        } else if (arg == "--steps" && i + 1 < argc) {
+            header.steps = std::stoull(argv[++i]);
+        } else if (arg == "--size" && i + 1 < argc) {
+            header.size = std::stoi(argv[++i]);
+        } else if (arg == "--field-every" && i + 1 < argc) {
+            header.fieldEvery = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            tolerance = std::stod(argv[++i]);
+        } else {
+            writePath.clear();
+            comparePath.clear();
+            break;
+        }
+    }
+
+    if (writePath.empty() == comparePath.empty()) {
+        std::cerr << "Usage: " << argv[0] << " --write trace.bin [--steps N] [--size S] [--field-every K]\n"
+                  << "       " << argv[0] << " --compare trace.bin [--tolerance relative]" << std::endl;
+        return 1;
+    }
+
+    if (!writePath.empty()) {
+        return writeTrace(writePath, header) ? 0 : 1;
+    }
+    return compareTrace(comparePath, tolerance) ? 0 : 1;
+}
@@ -20,3 +20,7 @@ void ProtectiveActionLogic::evaluateConditions(double coreTemperature, double co
 bool ProtectiveActionLogic::isScramInitiated() const {
     return scramInitiated;
 }
+
+void ProtectiveActionLogic::setScramInitiated(bool initiated) {
+    scramInitiated = initiated;
+}
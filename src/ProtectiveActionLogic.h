@@ -13,6 +13,7 @@ public:
 
     void evaluateConditions(double coreTemperature, double coolantFlowRate);
     bool isScramInitiated() const;
+    void setScramInitiated(bool initiated);
 
 private:
     bool scramInitiated;
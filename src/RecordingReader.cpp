@@ -0,0 +1,195 @@
+// RecordingReader.cpp
+//
+// Small command line reader for telemetry recordings written by TelemetryRecorder.
+//
+//   RecordingReader <file>                  Print the header and all scalar signals as CSV
+//   RecordingReader <file> --info           Print the header and chunk summary only
+//   RecordingReader <file> --field <name>   Print one per-cell field as CSV (one row per sample)
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "TelemetryFormat.h"
+
+namespace {
+
+struct FieldInfo {
+    std::string name;
+    std::uint32_t size;
+};
+
+template <typename T>
+bool readValue(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+template <typename T>
+bool readArray(std::ifstream& in, std::vector<T>& values, std::size_t count) {
+    values.resize(count);
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(count * sizeof(T))));
+}
+
+bool readName(std::ifstream& in, std::string& name) {
+    std::uint16_t length = 0;
+    if (!readValue(in, length)) {
+        return false;
+    }
+    name.resize(length);
+    return static_cast<bool>(in.read(name.data(), length));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <recording> [--info | --field <name>]" << std::endl;
+        return 1;
+    }
+
+    std::string path = argv[1];
+    bool infoOnly = false;
+    std::string fieldName;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--info") {
+            infoOnly = true;
+        } else if (arg == "--field" && i + 1 < argc) {
+            fieldName = argv[++i];
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "Failed to open " << path << std::endl;
+        return 1;
+    }
+
+    // Header
+    char magic[4];
+    std::uint32_t version = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, telemetryMagic, sizeof(magic)) != 0
+        || !readValue(in, version) || version != telemetryVersion) {
+        std::cerr << path << " is not a telemetry recording (or has an unsupported version)." << std::endl;
+        return 1;
+    }
+
+    std::uint32_t scalarCount = 0;
+    readValue(in, scalarCount);
+    std::vector<std::string> scalarNames(scalarCount);
+    for (auto& name : scalarNames) {
+        readName(in, name);
+    }
+
+    std::uint32_t fieldCount = 0;
+    readValue(in, fieldCount);
+    std::vector<FieldInfo> fields(fieldCount);
+    for (auto& field : fields) {
+        readName(in, field.name);
+        readValue(in, field.size);
+    }
+
+    std::uint32_t fieldDecimation = 0;
+    if (!readValue(in, fieldDecimation)) {
+        std::cerr << "Truncated header in " << path << std::endl;
+        return 1;
+    }
+
+    int selectedField = -1;
+    for (std::size_t f = 0; f < fields.size(); ++f) {
+        if (fields[f].name == fieldName) {
+            selectedField = static_cast<int>(f);
+        }
+    }
+    if (!fieldName.empty() && selectedField < 0) {
+        std::cerr << "Field '" << fieldName << "' is not in this recording." << std::endl;
+        return 1;
+    }
+
+    if (infoOnly || fieldName.empty()) {
+        std::cerr << "Scalar signals:";
+        for (const auto& name : scalarNames) {
+            std::cerr << " " << name;
+        }
+        std::cerr << "\nFields (every " << fieldDecimation << " steps):";
+        for (const auto& field : fields) {
+            std::cerr << " " << field.name << "[" << field.size << "]";
+        }
+        std::cerr << std::endl;
+    }
+
+    if (!infoOnly && fieldName.empty()) {
+        std::cout << "step";
+        for (const auto& name : scalarNames) {
+            std::cout << "," << name;
+        }
+        std::cout << "\n";
+    }
+
+    // Chunks
+    std::size_t scalarRows = 0;
+    std::size_t fieldRows = 0;
+    std::uint32_t type = 0;
+    std::uint32_t rows = 0;
+    std::vector<std::uint64_t> steps;
+    std::vector<std::vector<double>> columns;
+    std::vector<double> values;
+
+    while (readValue(in, type) && readValue(in, rows)) {
+        if (!readArray(in, steps, rows)) {
+            break;
+        }
+
+        if (type == static_cast<std::uint32_t>(TelemetryChunkType::Scalars)) {
+            columns.resize(scalarCount);
+            for (auto& column : columns) {
+                readArray(in, column, rows);
+            }
+            scalarRows += rows;
+
+            if (!infoOnly && fieldName.empty()) {
+                for (std::uint32_t r = 0; r < rows; ++r) {
+                    std::cout << steps[r];
+                    for (const auto& column : columns) {
+                        std::cout << "," << column[r];
+                    }
+                    std::cout << "\n";
+                }
+            }
+        } else if (type == static_cast<std::uint32_t>(TelemetryChunkType::Fields)) {
+            for (std::size_t f = 0; f < fields.size(); ++f) {
+                std::size_t count = static_cast<std::size_t>(rows) * fields[f].size;
+                if (static_cast<int>(f) != selectedField || infoOnly) {
+                    // Columnar layout: skip fields we were not asked for
+                    in.seekg(static_cast<std::streamoff>(count * sizeof(double)), std::ios::cur);
+                    continue;
+                }
+
+                readArray(in, values, count);
+                for (std::uint32_t r = 0; r < rows; ++r) {
+                    std::cout << steps[r];
+                    for (std::uint32_t i = 0; i < fields[f].size; ++i) {
+                        std::cout << "," << values[r * fields[f].size + i];
+                    }
+                    std::cout << "\n";
+                }
+            }
+            fieldRows += rows;
+        } else {
+            std::cerr << "Unknown chunk type " << type << "; stopping." << std::endl;
+            break;
+        }
+    }
+
+    if (infoOnly) {
+        std::cout << scalarRows << " scalar rows, " << fieldRows << " field samples" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,160 @@
+// ScenarioEngine.cpp
+
+#include "ScenarioEngine.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+bool ScenarioEngine::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Failed to open scenario " << path << std::endl;
+        return false;
+    }
+
+    timedEvents.clear();
+    conditionEvents.clear();
+    nextTimedEvent = 0;
+    endTime = -1.0;
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+
+        std::istringstream fields(line);
+        std::string directive;
+        fields >> directive;
+        if (directive.empty() || directive[0] == '#') {
+            continue;
+        }
+
+        bool valid = false;
+        if (directive == "at") {
+            TimedEvent event{};
+            fields >> event.time >> std::ws;
+            std::getline(fields, event.command);
+            valid = !fields.fail() && !event.command.empty();
+            if (valid && isRewind(event.command)) {
+                // "rewind to <time>" or "rewind <seconds>" back from the trigger time
+                std::istringstream target(event.command.substr(6));
+                std::string to;
+                double value = 0.0;
+                if (event.command.find("rewind to") == 0) {
+                    target >> to >> value;
+                } else {
+                    target >> value;
+                    value = event.time - value;
+                }
+                if (target.fail() || value < event.time) {
+                    std::cerr << path << ":" << lineNumber << ": a timed rewind may not return before its own time" << std::endl;
+                    return false;
+                }
+            }
+            if (valid) {
+                timedEvents.push_back(event);
+            }
+        } else if (directive == "when") {
+            ConditionEvent event{};
+            std::string signal, comparison;
+            fields >> signal >> comparison >> event.threshold >> std::ws;
+            std::getline(fields, event.command);
+            valid = !fields.fail() && !event.command.empty()
+                    && parseSignal(signal, event.signal) && parseComparison(comparison, event.comparison);
+            if (valid) {
+                conditionEvents.push_back(event);
+            }
+        } else if (directive == "end") {
+            fields >> endTime;
+            valid = !fields.fail();
+        }
+
+        if (!valid) {
+            std::cerr << path << ":" << lineNumber << ": invalid scenario line: " << line << std::endl;
+            return false;
+        }
+    }
+
+    std::stable_sort(timedEvents.begin(), timedEvents.end(),
+                     [](const TimedEvent& a, const TimedEvent& b) { return a.time < b.time; });
+
+    loaded = true;
+    return true;
+}
+
+void ScenarioEngine::evaluate(const PlantTelemetry& telemetry, std::vector<std::string>& commands) {
+    while (nextTimedEvent < timedEvents.size() && timedEvents[nextTimedEvent].time <= telemetry.simTime) {
+        commands.push_back(timedEvents[nextTimedEvent].command);
+        timedEvents[nextTimedEvent].firedAt = telemetry.simTime;
+        ++nextTimedEvent;
+    }
+
+    for (auto& event : conditionEvents) {
+        if (event.fired) {
+            continue;
+        }
+
+        double value = getSignalValue(telemetry, event.signal);
+        bool holds = false;
+        switch (event.comparison) {
+            case Comparison::Greater: holds = value > event.threshold; break;
+            case Comparison::GreaterEqual: holds = value >= event.threshold; break;
+            case Comparison::Less: holds = value < event.threshold; break;
+            case Comparison::LessEqual: holds = value <= event.threshold; break;
+        }
+
+        if (holds) {
+            commands.push_back(event.command);
+            event.fired = true;
+            event.firedAt = telemetry.simTime;
+        }
+    }
+}
+
+bool ScenarioEngine::isFinished(const PlantTelemetry& telemetry) const {
+    return hasEndTime() && telemetry.simTime >= endTime;
+}
+
+void ScenarioEngine::rewindTo(double simTime, double issuedAt) {
+    // A command issued at time t takes effect in the step after t, so a session restored at t
+    // or earlier has not seen it yet. A conditional rewind that fired at issuedAt is the one
+    // being applied; re-arming it would return to the same condition and rewind again.
+    while (nextTimedEvent > 0 && timedEvents[nextTimedEvent - 1].firedAt >= simTime) {
+        --nextTimedEvent;
+    }
+    for (auto& event : conditionEvents) {
+        if (event.fired && event.firedAt >= simTime && !(event.firedAt >= issuedAt && isRewind(event.command))) {
+            event.fired = false;
+        }
+    }
+}
+
+bool ScenarioEngine::isRewind(const std::string& command) {
+    return command.find("rewind") == 0;
+}
+
+bool ScenarioEngine::parseComparison(const std::string& text, Comparison& comparison) {
+    if (text == ">") {
+        comparison = Comparison::Greater;
+    } else if (text == ">=") {
+        comparison = Comparison::GreaterEqual;
+    } else if (text == "<") {
+        comparison = Comparison::Less;
+    } else if (text == "<=") {
+        comparison = Comparison::LessEqual;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool ScenarioEngine::parseSignal(const std::string& text, ScalarSignal& signal) {
+    for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(ScalarSignal::Count); ++i) {
+        if (text == getSignalName(static_cast<ScalarSignal>(i))) {
+            signal = static_cast<ScalarSignal>(i);
+            return true;
+        }
+    }
+    return false;
+}
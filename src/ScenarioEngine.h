@@ -0,0 +1,79 @@
+// ScenarioEngine.h
+
+#ifndef SCENARIOENGINE_H
+#define SCENARIOENGINE_H
+
+#include <string>
+#include <vector>
+
+#include "PlantTelemetry.h"
+#include "TelemetryFormat.h"
+
+// Scripted training scenario. A scenario file is a list of directives, one per line:
+//
+//   # comment
+//   at <seconds> <command>                  Run command once simulated time reaches <seconds>
+//   when <signal> <op> <value> <command>    Run command the first time the condition holds
+//   end <seconds>                           Stop the run at <seconds> of simulated time
+//
+// <command> is any operator command (e.g. "adjust rods 0.4", "initiate casualty leak"),
+// <signal> is a telemetry scalar name (e.g. maxCoreTemperature) and <op> is one of
+// > >= < <=. Conditions are checked against the telemetry published each step, so
+// evaluation costs O(pending events) per step regardless of Core size.
+//
+// Each event remembers the simulated time it fired at, so scenario progress follows a rewind:
+// events that fired at or after the restored time fire again, except a conditional rewind
+// that issued the rewind itself. A timed rewind must not target a time before its own trigger
+// (it would fire again every time it returned), so the loader rejects one.
+class ScenarioEngine {
+public:
+    bool load(const std::string& path);
+
+    // Appends the commands that fire at this step
+    void evaluate(const PlantTelemetry& telemetry, std::vector<std::string>& commands);
+
+    [[nodiscard]] bool isLoaded() const { return loaded; }
+    [[nodiscard]] bool hasEndTime() const { return endTime >= 0.0; }
+    [[nodiscard]] bool isFinished(const PlantTelemetry& telemetry) const;
+
+    // Returns to the progress of a session restored at simTime by a rewind issued at issuedAt
+    void rewindTo(double simTime, double issuedAt);
+
+private:
+    enum class Comparison {
+        Greater,
+        GreaterEqual,
+        Less,
+        LessEqual
+    };
+
+    struct TimedEvent {
+        double time;
+        std::string command;
+        double firedAt;
+    };
+
+    struct ConditionEvent {
+        ScalarSignal signal;
+        Comparison comparison;
+        double threshold;
+        std::string command;
+        bool fired;
+        double firedAt;
+    };
+
+    bool loaded = false;
+    double endTime = -1.0;
+
+    // Sorted by time; nextTimedEvent only moves back on a rewind
+    std::vector<TimedEvent> timedEvents;
+    std::size_t nextTimedEvent = 0;
+
+    std::vector<ConditionEvent> conditionEvents;
+
+    static bool isRewind(const std::string& command);
+    static bool parseComparison(const std::string& text, Comparison& comparison);
+    static bool parseSignal(const std::string& text, ScalarSignal& signal);
+};
+
+#endif // SCENARIOENGINE_H
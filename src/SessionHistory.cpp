@@ -0,0 +1,389 @@
+// SessionHistory.cpp
+
+#include "SessionHistory.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include "Core.h"
+#include "CoolantSystem.h"
+
+namespace {
+
+std::uint64_t toBits(double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double fromBits(std::uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Appends bits most significant first; a frame always ends on a byte boundary so frames
+// can be addressed by byte offset. value must fit in bits (at most 64).
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<std::uint8_t>& out) : out(out) {}
+    ~BitWriter() {
+        if (count > 0) {
+            out.push_back(static_cast<std::uint8_t>(pending << (8 - count)));
+        }
+    }
+
+    void write(std::uint64_t value, int bits) {
+        if (bits > 32) {
+            write(value >> 32, bits - 32);
+            value &= 0xffffffffu;
+            bits = 32;
+        }
+        // At most 7 bits are held over, so 32 more always fit
+        pending = (pending << bits) | value;
+        count += bits;
+        while (count >= 8) {
+            count -= 8;
+            out.push_back(static_cast<std::uint8_t>(pending >> count));
+        }
+    }
+
+private:
+    std::vector<std::uint8_t>& out;
+    std::uint64_t pending = 0;
+    int count = 0;
+};
+
+// Reads bits in the order BitWriter wrote them, from a frame ending at end
+class BitReader {
+public:
+    BitReader(const std::uint8_t* in, const std::uint8_t* end) : in(in), end(end) {}
+
+    std::uint64_t read(int bits) {
+        if (bits > 32) {
+            std::uint64_t high = read(bits - 32);
+            return (high << 32) | read(32);
+        }
+        if (count < bits) {
+            refill();
+        }
+        count -= bits;
+        return (pending >> count) & ((std::uint64_t{1} << bits) - 1);
+    }
+
+    // Consumes zero bits up to the next one bit or the limit; returns how many
+    std::size_t skipZeros(std::size_t limit) {
+        std::size_t skipped = 0;
+        while (skipped < limit) {
+            if (count == 0) {
+                refill();
+            }
+            std::uint64_t available = pending & ((std::uint64_t{1} << count) - 1);
+            std::size_t zeros = available == 0 ? static_cast<std::size_t>(count)
+                                               : static_cast<std::size_t>(std::countl_zero(available) - (64 - count));
+            std::size_t take = std::min(zeros, limit - skipped);
+            count -= static_cast<int>(take);
+            skipped += take;
+            if (available != 0) {
+                break;
+            }
+        }
+        return skipped;
+    }
+
+private:
+    const std::uint8_t* in;
+    const std::uint8_t* end;
+    std::uint64_t pending = 0;
+    int count = 0; // Unread bits at the bottom of pending, at most 63
+
+    void refill() {
+        while (count <= 55 && in != end) {
+            pending = (pending << 8) | *in++;
+            count += 8;
+        }
+    }
+};
+
+constexpr int maxLeadingZeros = 31; // Fits the 5-bit field
+
+// Delta stream, Gorilla style: each value's bits are XORed with the previous frame's.
+//   0                       unchanged
+//   10 <bits>               the XOR fits the previous window; only its bits are stored
+//   11 <5: leading zeros> <6: length - 1> <bits>   new window of significant bits
+// A changed value only differs in its low mantissa bits, and a float-fields build leaves
+// the 29 bits below float precision zero, so both ends of the XOR are usually dropped.
+void encodeDelta(std::vector<std::uint8_t>& out, const std::vector<double>& previous,
+                 const std::vector<double>& current) {
+    BitWriter writer(out);
+    int windowLeading = -1;
+    int windowTrailing = 0;
+    std::size_t i = 0;
+    while (i < current.size()) {
+        std::size_t unchanged = 0;
+        while (i < current.size() && toBits(previous[i]) == toBits(current[i])) {
+            ++unchanged;
+            ++i;
+        }
+        while (unchanged > 0) {
+            std::size_t bits = std::min<std::size_t>(unchanged, 32);
+            writer.write(0, static_cast<int>(bits));
+            unchanged -= bits;
+        }
+        if (i == current.size()) {
+            break;
+        }
+
+        std::uint64_t x = toBits(previous[i]) ^ toBits(current[i]);
+        ++i;
+
+        int leading = std::min(std::countl_zero(x), maxLeadingZeros);
+        int trailing = std::countr_zero(x);
+        if (windowLeading >= 0 && leading >= windowLeading && trailing >= windowTrailing) {
+            writer.write(0b10, 2);
+            writer.write(x >> windowTrailing, 64 - windowLeading - windowTrailing);
+        } else {
+            int length = 64 - leading - trailing;
+            writer.write(0b11, 2);
+            writer.write(static_cast<std::uint64_t>(leading), 5);
+            writer.write(static_cast<std::uint64_t>(length - 1), 6);
+            writer.write(x >> trailing, length);
+            windowLeading = leading;
+            windowTrailing = trailing;
+        }
+    }
+}
+
+void decodeDelta(const std::uint8_t* in, const std::uint8_t* end, std::vector<double>& frame) {
+    BitReader reader(in, end);
+    int windowLeading = 0;
+    int windowTrailing = 0;
+    std::size_t i = 0;
+    while (i < frame.size()) {
+        i += reader.skipZeros(frame.size() - i);
+        if (i == frame.size()) {
+            break;
+        }
+
+        reader.read(1);
+        if (reader.read(1) == 1) {
+            windowLeading = static_cast<int>(reader.read(5));
+            windowTrailing = 64 - windowLeading - static_cast<int>(reader.read(6)) - 1;
+        }
+        std::uint64_t x = reader.read(64 - windowLeading - windowTrailing) << windowTrailing;
+        frame[i] = fromBits(toBits(frame[i]) ^ x);
+        ++i;
+    }
+}
+
+} // namespace
+
+SessionHistory::SessionHistory(double keyframeInterval, std::size_t memoryBudget)
+    : keyframeInterval(keyframeInterval),
+      memoryBudget(memoryBudget),
+      blocking(false),
+      encoderBusy(false),
+      stopping(false),
+      memoryUsage(0) {
+    encoderThread = std::thread(&SessionHistory::encoderLoop, this);
+}
+
+SessionHistory::~SessionHistory() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCondition.notify_all();
+
+    if (encoderThread.joinable()) {
+        encoderThread.join();
+    }
+}
+
+void SessionHistory::capture(double simTime, bool scramInitiated, const Core& core, const CoolantSystem& coolantSystem) {
+    std::vector<double> frame;
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        if (blocking) {
+            idleCondition.wait(lock, [this] { return pending.size() < maxPendingFrames; });
+        }
+        if (pending.size() >= maxPendingFrames) {
+            // Encoder is behind; skipping a frame only coarsens the history
+            return;
+        }
+        if (!freeFrames.empty()) {
+            frame = std::move(freeFrames.back());
+            freeFrames.pop_back();
+        }
+    }
+
+    frame.clear();
+    frame.push_back(simTime);
+    frame.push_back(scramInitiated ? 1.0 : 0.0);
+    frame.push_back(static_cast<double>(core.getStateSize()));
+    {
+        std::lock_guard<std::mutex> lock(core.getMutex());
+        core.captureState(frame);
+    }
+    coolantSystem.captureState(frame); // Locks each loop in turn
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        pending.push_back(std::move(frame));
+    }
+    queueCondition.notify_one();
+}
+
+void SessionHistory::encoderLoop() {
+    while (true) {
+        std::vector<double> frame;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (stopping) {
+                return;
+            }
+            frame = std::move(pending.front());
+            pending.pop_front();
+            encoderBusy = true;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(historyMutex);
+            encodeFrame(frame);
+            evictOldSegments();
+
+            // The new frame becomes the delta reference; recycle the old reference buffer
+            std::swap(previous, frame);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (!frame.empty()) {
+                freeFrames.push_back(std::move(frame));
+            }
+            encoderBusy = false;
+        }
+        idleCondition.notify_all();
+    }
+}
+
+void SessionHistory::encodeFrame(const std::vector<double>& frame) {
+    bool needKeyframe = segments.empty()
+                        || previous.size() != frame.size()
+                        || previous[2] != frame[2]
+                        || frame[0] < previous[0]
+                        || frame[0] - segments.back().frameTimes.front() >= keyframeInterval;
+
+    if (needKeyframe) {
+        Segment segment;
+        segment.keyframe = frame;
+        segment.frameTimes.push_back(frame[0]);
+        segment.frameOffsets.push_back(0);
+        memoryUsage += segmentBytes(segment);
+        segments.push_back(std::move(segment));
+        return;
+    }
+
+    Segment& segment = segments.back();
+    std::size_t before = segmentBytes(segment);
+
+    segment.frameTimes.push_back(frame[0]);
+    segment.frameOffsets.push_back(segment.deltas.size());
+    encodeDelta(segment.deltas, previous, frame);
+
+    memoryUsage += segmentBytes(segment) - before;
+}
+
+void SessionHistory::evictOldSegments() {
+    // Always keep the segment currently being appended to
+    while (memoryUsage > memoryBudget && segments.size() > 1) {
+        memoryUsage -= segmentBytes(segments.front());
+        segments.pop_front();
+    }
+}
+
+std::size_t SessionHistory::segmentBytes(const Segment& segment) {
+    return segment.keyframe.size() * sizeof(double)
+           + segment.deltas.size()
+           + segment.frameTimes.size() * (sizeof(double) + sizeof(std::size_t));
+}
+
+bool SessionHistory::rewind(double targetTime, Core& core, CoolantSystem& coolantSystem,
+                            double& restoredTime, bool& scramInitiated) {
+    // Let the encoder catch up so the newest frames are searchable
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        idleCondition.wait(lock, [this] { return pending.empty() && !encoderBusy; });
+    }
+
+    std::lock_guard<std::mutex> lock(historyMutex);
+    if (segments.empty()) {
+        return false;
+    }
+
+    // Latest segment whose keyframe is not after the target; clamp to the oldest one
+    auto it = std::upper_bound(segments.begin(), segments.end(), targetTime,
+                               [](double t, const Segment& s) { return t < s.frameTimes.front(); });
+    if (it != segments.begin()) {
+        --it;
+    }
+    Segment& segment = *it;
+
+    // Replay deltas forward from the keyframe: at most one keyframe interval of work
+    std::vector<double> frame = segment.keyframe;
+    std::size_t frameCount = 1;
+    while (frameCount < segment.frameTimes.size() && segment.frameTimes[frameCount] <= targetTime) {
+        const std::uint8_t* deltas = segment.deltas.data();
+        std::size_t frameEnd = frameCount + 1 < segment.frameOffsets.size() ? segment.frameOffsets[frameCount + 1]
+                                                                            : segment.deltas.size();
+        decodeDelta(deltas + segment.frameOffsets[frameCount], deltas + frameEnd, frame);
+        ++frameCount;
+    }
+
+    // Restore the coolant first: it checks the whole snapshot before changing anything, and
+    // with the core's size checked up front a mismatch leaves the plant and history untouched
+    auto coreSize = static_cast<std::size_t>(frame[2]);
+    const double* coreState = frame.data() + headerSize;
+    if (coreSize != core.getStateSize() || frame.size() < headerSize + coreSize
+        || !coolantSystem.restoreState(coreState + coreSize, frame.size() - headerSize - coreSize)) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> coreLock(core.getMutex());
+        core.restoreState(coreState, coreSize);
+    }
+    restoredTime = frame[0];
+    scramInitiated = frame[1] != 0.0;
+
+    // The future diverges from here, so drop everything after the restored frame
+    for (auto later = it + 1; later != segments.end(); ++later) {
+        memoryUsage -= segmentBytes(*later);
+    }
+    segments.erase(it + 1, segments.end());
+
+    std::size_t before = segmentBytes(segment);
+    if (frameCount < segment.frameTimes.size()) {
+        segment.deltas.resize(segment.frameOffsets[frameCount]);
+        segment.frameTimes.resize(frameCount);
+        segment.frameOffsets.resize(frameCount);
+    }
+    memoryUsage -= before - segmentBytes(segment);
+
+    previous = frame;
+    return true;
+}
+
+double SessionHistory::getOldestTime() const {
+    std::lock_guard<std::mutex> lock(historyMutex);
+    return segments.empty() ? 0.0 : segments.front().frameTimes.front();
+}
+
+double SessionHistory::getNewestTime() const {
+    std::lock_guard<std::mutex> lock(historyMutex);
+    return segments.empty() ? 0.0 : segments.back().frameTimes.back();
+}
+
+std::size_t SessionHistory::getMemoryUsage() const {
+    std::lock_guard<std::mutex> lock(historyMutex);
+    return memoryUsage;
+}
@@ -0,0 +1,88 @@
+// SessionHistory.h
+
+#ifndef SESSIONHISTORY_H
+#define SESSIONHISTORY_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Core;
+class CoolantSystem;
+
+// In-memory rewind buffer for a training session.
+//
+// Every captured frame is the full plant state (Core + CoolantSystem) flattened to doubles.
+// A keyframe is stored verbatim every keyframeInterval seconds, and the frames in between
+// are stored as the XOR of each value against the previous frame, packed Gorilla style:
+// one bit for an unchanged value, otherwise only the XOR's significant bits. Encoding
+// happens on a background thread so the simulation thread only pays for copying the state
+// into a recycled buffer.
+class SessionHistory {
+public:
+    explicit SessionHistory(double keyframeInterval = 5.0, std::size_t memoryBudget = 128 * 1024 * 1024);
+    ~SessionHistory();
+
+    SessionHistory(const SessionHistory&) = delete;
+    SessionHistory& operator=(const SessionHistory&) = delete;
+
+    // When blocking, capture waits for the encoder instead of skipping frames, so the set of
+    // stored frames is deterministic (used by replay)
+    void setBlocking(bool block) { blocking = block; }
+
+    // Called from the simulation thread after each step
+    void capture(double simTime, bool scramInitiated, const Core& core, const CoolantSystem& coolantSystem);
+
+    // Restores the latest frame at or before targetTime (or the oldest frame still held) and
+    // discards everything after it. Returns false, changing nothing, if there is no history yet
+    // or the frame does not fit the plant.
+    bool rewind(double targetTime, Core& core, CoolantSystem& coolantSystem,
+                double& restoredTime, bool& scramInitiated);
+
+    [[nodiscard]] double getOldestTime() const;
+    [[nodiscard]] double getNewestTime() const;
+    [[nodiscard]] std::size_t getMemoryUsage() const;
+
+private:
+    // Frame header: simTime, scram flag, size of the Core block; then Core and CoolantSystem state
+    static constexpr std::size_t headerSize = 3;
+    static constexpr std::size_t maxPendingFrames = 64;
+
+    struct Segment {
+        std::vector<double> keyframe;
+        std::vector<std::uint8_t> deltas;
+        std::vector<double> frameTimes;          // frameTimes[0] is the keyframe
+        std::vector<std::size_t> frameOffsets;   // Start of frame i in deltas (frameOffsets[0] unused)
+    };
+
+    double keyframeInterval;
+    std::size_t memoryBudget;
+
+    // Hand-off between the simulation thread and the encoder
+    std::deque<std::vector<double>> pending;
+    std::vector<std::vector<double>> freeFrames;
+    bool blocking;
+    bool encoderBusy;
+    bool stopping;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::condition_variable idleCondition;
+
+    // Encoded history, owned by the encoder thread except during rewind
+    std::deque<Segment> segments;
+    std::vector<double> previous;
+    std::size_t memoryUsage;
+    mutable std::mutex historyMutex;
+
+    std::thread encoderThread;
+
+    void encoderLoop();
+    void encodeFrame(const std::vector<double>& frame);
+    void evictOldSegments();
+    static std::size_t segmentBytes(const Segment& segment);
+};
+
+#endif // SESSIONHISTORY_H
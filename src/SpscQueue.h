@@ -0,0 +1,64 @@
+// SpscQueue.h
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded lock-free single-producer/single-consumer ring buffer.
+// tryPush may only be called from one thread and tryPop from one (other) thread.
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(std::size_t capacity) {
+        // Round up to a power of two so wrapping is a mask
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        buffer.resize(size);
+        mask = size - 1;
+    }
+
+    bool tryPush(const T& value) {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead > mask) {
+                return false; // Full
+            }
+        }
+        buffer[t & mask] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& value) {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h == cachedTail) {
+                return false; // Empty
+            }
+        }
+        value = buffer[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] std::size_t capacity() const { return buffer.size(); }
+
+private:
+    std::vector<T> buffer;
+    std::size_t mask;
+
+    // Producer and consumer indices on separate cache lines, each with a private copy of the other
+    alignas(64) std::atomic<std::size_t> tail{0};
+    std::size_t cachedHead{0};
+    alignas(64) std::atomic<std::size_t> head{0};
+    std::size_t cachedTail{0};
+};
+
+#endif // SPSCQUEUE_H
@@ -0,0 +1,120 @@
+// SteamGenerator.cpp
+
+#include "SteamGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include "TridiagonalSolver.h"
+#include "WaterProperties.h"
+
+namespace {
+
+// dT/dh of each point: 1/cp in single phase, 0 on the saturation plateau
+void temperatureSlopes(double pressure, std::span<const double> enthalpies, std::span<const double> temperatures,
+                       std::span<double> slopes) {
+    const WaterProperties& properties = WaterProperties::get();
+    properties.lookup(WaterProperties::Property::HeatCapacity, pressure, temperatures, slopes);
+    const WaterProperties::Saturation saturation = properties.saturation(pressure);
+    for (std::size_t i = 0; i < slopes.size(); ++i) {
+        const bool boiling = enthalpies[i] > saturation.liquidEnthalpy && enthalpies[i] < saturation.vapourEnthalpy;
+        slopes[i] = boiling ? 0.0 : 1.0 / slopes[i];
+    }
+}
+
+} // namespace
+
+SteamGenerator::SteamGenerator(int nodeCount)
+    : secondaryPressure(6.9e6), feedwaterTemperature(300.0), feedwaterFlowRate(6.0), feedwaterTripped(false),
+      conductance(4.0e5), steamPower(0.0) {
+    // The plant starts cold, secondary included
+    secondaryEnthalpy.assign(std::max(1, nodeCount),
+                             WaterProperties::get().lookup(WaterProperties::Property::Enthalpy, secondaryPressure, 300.0));
+}
+
+double SteamGenerator::exchangeHeat(std::span<double> primaryEnthalpy, std::span<const double> primaryMass,
+                                    double primaryChunkMass, double primaryPressure, double deltaTime) {
+    if (feedwaterTripped) {
+        feedwaterFlowRate *= std::exp(-deltaTime / feedwaterCoastdownTime);
+    }
+
+    const WaterProperties& properties = WaterProperties::get();
+    const std::size_t nodes = secondaryEnthalpy.size();
+    const std::size_t tubes = std::min(primaryEnthalpy.size(), nodes);
+    std::span<const double> primary = primaryEnthalpy.first(tubes);
+
+    primaryTemperature.resize(tubes);
+    primarySlope.resize(tubes);
+    secondaryTemperature.resize(nodes);
+    secondarySlope.resize(nodes);
+    effectiveConductance.resize(nodes);
+    lower.resize(nodes);
+    diagonal.resize(nodes);
+    upper.resize(nodes);
+    rhs.resize(nodes);
+
+    // Both sides' temperatures and dT/dh at the start of the step, in batches
+    properties.temperatures(primaryPressure, primary, primaryTemperature);
+    temperatureSlopes(primaryPressure, primary, primaryTemperature, primarySlope);
+    properties.temperatures(secondaryPressure, secondaryEnthalpy, secondaryTemperature);
+    temperatureSlopes(secondaryPressure, secondaryEnthalpy, secondaryTemperature, secondarySlope);
+
+    const double storage = secondaryMass / static_cast<double>(nodes) / deltaTime; // kg/s
+    const double nodeConductance = conductance / static_cast<double>(nodes);
+    const double feedwaterEnthalpy =
+        properties.lookup(WaterProperties::Property::Enthalpy, secondaryPressure, feedwaterTemperature);
+
+    // Secondary energy balance per node: storage, feedwater advection from the cold end,
+    // recirculation with both neighbours, and the tube heat linearized in the new enthalpy.
+    // A partly drained chunk wets part of the tubes; per kg it sees the conductance of a full one.
+    for (std::size_t j = 0; j < nodes; ++j) {
+        const double ua = j < tubes ? std::min(1.0, primaryMass[j] / primaryChunkMass) * nodeConductance
+                                          / (1.0 + nodeConductance * deltaTime * primarySlope[j] / primaryChunkMass)
+                                    : 0.0;
+        const double mixingBefore = j > 0 ? recirculationRate : 0.0;
+        const double mixingAfter = j + 1 < nodes ? recirculationRate : 0.0;
+        effectiveConductance[j] = ua;
+        lower[j] = -(feedwaterFlowRate + mixingBefore);
+        upper[j] = -mixingAfter;
+        diagonal[j] = storage + feedwaterFlowRate + mixingBefore + mixingAfter + ua * secondarySlope[j];
+        rhs[j] = storage * secondaryEnthalpy[j];
+        if (j < tubes) {
+            rhs[j] += ua * (primaryTemperature[j] - secondaryTemperature[j] + secondarySlope[j] * secondaryEnthalpy[j]);
+        }
+    }
+    rhs[0] += feedwaterFlowRate * feedwaterEnthalpy;
+    solveTridiagonal(lower, diagonal, upper, rhs);
+
+    // The primary gives up exactly the heat the secondary took in through each node
+    double heat = 0.0;
+    for (std::size_t j = 0; j < tubes; ++j) {
+        const double secondaryEnd = secondaryTemperature[j] + secondarySlope[j] * (rhs[j] - secondaryEnthalpy[j]);
+        const double nodeHeat = effectiveConductance[j] * (primaryTemperature[j] - secondaryEnd) * deltaTime;
+        if (nodeHeat != 0.0) {
+            primaryEnthalpy[j] -= nodeHeat / primaryMass[j];
+        }
+        heat += nodeHeat;
+    }
+
+    std::copy(rhs.begin(), rhs.end(), secondaryEnthalpy.begin());
+    steamPower = feedwaterFlowRate * (secondaryEnthalpy.back() - feedwaterEnthalpy);
+    return heat;
+}
+
+double SteamGenerator::getSecondaryTemperature(int node) const {
+    return WaterProperties::get().temperature(secondaryPressure, secondaryEnthalpy[node]);
+}
+
+double SteamGenerator::getSteamTemperature() const {
+    return getSecondaryTemperature(getNodeCount() - 1);
+}
+
+void SteamGenerator::captureState(std::vector<double>& state) const {
+    state.push_back(feedwaterFlowRate);
+    state.push_back(feedwaterTripped ? 1.0 : 0.0);
+    state.insert(state.end(), secondaryEnthalpy.begin(), secondaryEnthalpy.end());
+}
+
+void SteamGenerator::restoreState(const double* state) {
+    feedwaterFlowRate = state[0];
+    feedwaterTripped = state[1] != 0.0;
+    std::copy(state + stateHeaderSize, state + getStateSize(), secondaryEnthalpy.begin());
+}
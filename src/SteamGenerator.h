@@ -0,0 +1,81 @@
+// SteamGenerator.h
+
+#ifndef STEAMGENERATOR_H
+#define STEAMGENERATOR_H
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+// A loop's steam generator: the primary coolant passes through the tubes, the secondary side
+// boils feedwater into steam for the turbine at a set pressure.
+//
+// The tube bundle is split into nodes along its length, one per primary chunk in the tubes.
+// Feedwater enters the secondary at the cold end (where the primary leaves) and flows toward
+// the hot end, counter to the primary; recirculation mixes neighbouring nodes. Each step
+// solves the secondary enthalpies implicitly:
+//
+//   M (h_j' - h_j) / dt = m_fw (h_j-1' - h_j') + m_r (h_j-1' - 2 h_j' + h_j+1')
+//                         + UA_j (T_p,j - T_s,j(h_j'))
+//
+// with T_s linearized about the step start (dT/dh = 1/cp, or 0 while boiling), which is one
+// tridiagonal solve. The primary side of each node is implicit through its effective
+// conductance UA / (1 + UA dt dT/dh / m), so neither side can overshoot the other at large
+// steps and the heat one side gives up is exactly what the other takes.
+class SteamGenerator {
+public:
+    explicit SteamGenerator(int nodeCount);
+
+    // Exchanges heat for one step with the primary chunks in the tubes. primaryEnthalpy[j] is
+    // the chunk beside node j from the cold end and is updated in place; primaryMass[j] is its
+    // mass, which wets that fraction of the node's tubes against a full primaryChunkMass.
+    // Fewer chunks than nodes leave the hot-end nodes dry. Returns the heat taken from the
+    // primary (J).
+    double exchangeHeat(std::span<double> primaryEnthalpy, std::span<const double> primaryMass,
+                        double primaryChunkMass, double primaryPressure, double deltaTime);
+
+    [[nodiscard]] int getNodeCount() const { return static_cast<int>(secondaryEnthalpy.size()); }
+    [[nodiscard]] double getSecondaryTemperature(int node) const;
+    [[nodiscard]] double getSteamTemperature() const; // Secondary outlet
+    [[nodiscard]] double getSteamPower() const { return steamPower; } // W carried to the turbine
+
+    // Secondary conditions
+    void setSecondaryPressure(double pressure) { secondaryPressure = pressure; }
+    [[nodiscard]] double getSecondaryPressure() const { return secondaryPressure; }
+    void setFeedwaterTemperature(double temperature) { feedwaterTemperature = temperature; }
+    [[nodiscard]] double getFeedwaterTemperature() const { return feedwaterTemperature; }
+    void setFeedwaterFlowRate(double rate) { feedwaterFlowRate = rate; }
+    [[nodiscard]] double getFeedwaterFlowRate() const { return feedwaterFlowRate; }
+    void tripFeedwater() { feedwaterTripped = true; } // Feed pumps coast down
+    [[nodiscard]] bool isFeedwaterTripped() const { return feedwaterTripped; }
+    void setConductance(double ua) { conductance = ua; } // W/K over the whole bundle
+    [[nodiscard]] double getConductance() const { return conductance; }
+
+    static constexpr double secondaryMass = 50.0;         // kg of secondary water in the bundle
+    static constexpr double recirculationRate = 20.0;     // kg/s between neighbouring nodes
+    static constexpr double feedwaterCoastdownTime = 2.0; // s, flow e-folding time after a trip
+
+    // Session history snapshots (appended to / read from a flat buffer)
+    [[nodiscard]] std::size_t getStateSize() const { return stateHeaderSize + secondaryEnthalpy.size(); }
+    void captureState(std::vector<double>& state) const;
+    void restoreState(const double* state);
+
+private:
+    double secondaryPressure;
+    double feedwaterTemperature;
+    double feedwaterFlowRate;
+    bool feedwaterTripped;
+    double conductance;
+    double steamPower;
+    std::vector<double> secondaryEnthalpy; // J/kg per node, cold end first
+
+    // Scratch for the step
+    std::vector<double> primaryTemperature, primarySlope;
+    std::vector<double> secondaryTemperature, secondarySlope;
+    std::vector<double> effectiveConductance;
+    std::vector<double> lower, diagonal, upper, rhs;
+
+    static constexpr std::size_t stateHeaderSize = 2; // feedwaterFlowRate, feedwaterTripped
+};
+
+#endif // STEAMGENERATOR_H
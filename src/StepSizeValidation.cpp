@@ -0,0 +1,97 @@
+// StepSizeValidation.cpp
+//
+// Checks that the coolant loops reach the same state at any time step.
+//
+//   StepSizeValidation [--power W] [--loops N] [--time s] [--tolerance K]
+//
+// Runs an isolated coolant system (no core) at a fixed core power with each time step from
+// the interactive 1/30 s up to the largest fast-forward step, averages the core outlet and
+// inlet temperatures and the steam power over the last quarter of the run, and reports each
+// step's deviation from the smallest one. Exits 1 if a temperature differs by more than the
+// tolerance or the steam power by more than a percent.
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "CoolantSystem.h"
+
+namespace {
+
+constexpr int chunksPerLoop = 100;
+constexpr double timeSteps[] = { 1.0 / 30.0, 0.1, 0.25, 0.5 };
+
+struct LoopAverages {
+    double outletTemperature = 0.0;
+    double inletTemperature = 0.0;
+    double steamPower = 0.0;
+};
+
+LoopAverages run(int loops, double power, double duration, double timeStep) {
+    CoolantSystem coolantSystem(loops, chunksPerLoop);
+    const auto steps = static_cast<long>(std::llround(duration / timeStep));
+    const long averageFrom = steps - steps / 4;
+
+    LoopAverages averages;
+    for (long step = 0; step < steps; ++step) {
+        coolantSystem.advance(timeStep, power * timeStep);
+        if (step >= averageFrom) {
+            averages.outletTemperature += coolantSystem.getOutletTemperature();
+            averages.inletTemperature += coolantSystem.getInletTemperature();
+            averages.steamPower += coolantSystem.getSteamPower();
+        }
+    }
+
+    const auto samples = static_cast<double>(steps - averageFrom);
+    averages.outletTemperature /= samples;
+    averages.inletTemperature /= samples;
+    averages.steamPower /= samples;
+    return averages;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    double power = 20.0e6;
+    int loops = 2;
+    double duration = 400.0;
+    double tolerance = 2.0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--power" && i + 1 < argc) {
+            power = std::stod(argv[++i]);
+        } else if (arg == "--loops" && i + 1 < argc) {
+            loops = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--time" && i + 1 < argc) {
+            duration = std::stod(argv[++i]);
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            tolerance = std::stod(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--power W] [--loops N] [--time s] [--tolerance K]" << std::endl;
+            return 1;
+        }
+    }
+
+    bool passed = true;
+    const LoopAverages reference = run(loops, power, duration, timeSteps[0]);
+    std::cout << std::fixed << std::setprecision(2);
+    for (double timeStep : timeSteps) {
+        const LoopAverages averages = timeStep == timeSteps[0] ? reference : run(loops, power, duration, timeStep);
+        const double outletError = std::abs(averages.outletTemperature - reference.outletTemperature);
+        const double inletError = std::abs(averages.inletTemperature - reference.inletTemperature);
+        const double steamError = std::abs(averages.steamPower - reference.steamPower) / std::max(1.0, reference.steamPower);
+        const bool ok = outletError <= tolerance && inletError <= tolerance && steamError <= 0.01;
+        passed = passed && ok;
+
+        std::cout << "dt " << std::setw(6) << timeStep << " s: outlet " << averages.outletTemperature
+                  << " K, inlet " << averages.inletTemperature << " K, steam "
+                  << (averages.steamPower / 1.0e6) << " MW" << (ok ? "" : "  <-- differs") << "\n";
+    }
+
+    std::cout << (passed ? "Coolant state agrees across time steps." : "Coolant state depends on the time step.") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,59 @@
+// SweepDriver.cpp
+//
+// Parameter sweeps and Monte Carlo uncertainty studies of trip behaviour.
+//
+//   SweepDriver <sweep file> [--threads T] [--runs file.csv] [--summary file.csv]
+//
+// See ParameterSweep.h for the sweep file format. --runs writes one row per simulation,
+// --summary one row per grid point; the summary is always printed.
+
+#include <iostream>
+#include <string>
+
+#include "ParameterSweep.h"
+
+int main(int argc, char* argv[]) {
+    std::string sweepPath;
+    std::string runsPath;
+    std::string summaryPath;
+    std::size_t threadCount = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            threadCount = std::stoul(argv[++i]);
+        } else if (arg == "--runs" && i + 1 < argc) {
+            runsPath = argv[++i];
+        } else if (arg == "--summary" && i + 1 < argc) {
+            summaryPath = argv[++i];
+        } else if (sweepPath.empty() && arg[0] != '-') {
+            sweepPath = arg;
+        } else {
+            sweepPath.clear();
+            break;
+        }
+    }
+
+    if (sweepPath.empty()) {
+        std::cerr << "Usage: " << argv[0] << " <sweep file> [--threads T] [--runs file.csv] [--summary file.csv]"
+                  << std::endl;
+        return 1;
+    }
+
+    ParameterSweep sweep;
+    if (!sweep.load(sweepPath)) {
+        return 1;
+    }
+
+    sweep.run(threadCount);
+    sweep.printSummary();
+
+    bool ok = true;
+    if (!runsPath.empty()) {
+        ok = sweep.writeRuns(runsPath) && ok;
+    }
+    if (!summaryPath.empty()) {
+        ok = sweep.writeSummary(summaryPath) && ok;
+    }
+    return ok ? 0 : 1;
+}
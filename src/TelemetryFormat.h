@@ -0,0 +1,110 @@
+// TelemetryFormat.h
+
+#ifndef TELEMETRYFORMAT_H
+#define TELEMETRYFORMAT_H
+
+#include <cstdint>
+
+#include "PlantTelemetry.h"
+
+// On-disk layout of a telemetry recording (native endianness):
+//
+//   Header:
+//     char[4]  magic "RXTR"
+//     u32      version
+//     u32      scalar column count, then per column: u16 name length + name bytes
+//     u32      field count, then per field: u16 name length + name bytes + u32 values per sample
+//     u32      field decimation (steps between field samples)
+//
+//   Chunks until end of file, each:
+//     u32      chunk type
+//     u32      row count
+//     Scalar chunk: u64 step[rows], then for each scalar column f64 value[rows]
+//     Field chunk:  u64 step[rows], then for each field f64 value[rows * valuesPerSample]
+//
+// Columns are stored contiguously within a chunk so a reader can pull one signal
+// without touching the others. The coolantTemperature field holds each coolant loop's
+// chunks in turn, chunks-per-loop values per loop.
+
+constexpr char telemetryMagic[4] = {'R', 'X', 'T', 'R'};
+constexpr std::uint32_t telemetryVersion = 1;
+
+enum class TelemetryChunkType : std::uint32_t {
+    Scalars = 1,
+    Fields = 2
+};
+
+enum class ScalarSignal : std::uint32_t {
+    SimTime,
+    MaxCoreTemperature,
+    TotalPower,
+    UpperCoolantTemperature,
+    LowerCoolantTemperature,
+    ControlRodInsertion,
+    ScramInitiated,
+    CoolantFlowRate,
+    HotChannelTemperature,
+    CoreVoidFraction,
+    SteamPower,
+    CoolantInventory,
+    PressurizerLevel,
+    Count
+};
+
+enum class FieldSignal : std::uint32_t {
+    CoreTemperature,
+    NeutronPopulation,
+    NeutronFlux,
+    CoolantTemperature,
+    Count
+};
+
+inline const char* getSignalName(ScalarSignal signal) {
+    switch (signal) {
+        case ScalarSignal::SimTime: return "simTime";
+        case ScalarSignal::MaxCoreTemperature: return "maxCoreTemperature";
+        case ScalarSignal::TotalPower: return "totalPower";
+        case ScalarSignal::UpperCoolantTemperature: return "upperCoolantTemperature";
+        case ScalarSignal::LowerCoolantTemperature: return "lowerCoolantTemperature";
+        case ScalarSignal::ControlRodInsertion: return "controlRodInsertion";
+        case ScalarSignal::ScramInitiated: return "scramInitiated";
+        case ScalarSignal::CoolantFlowRate: return "coolantFlowRate";
+        case ScalarSignal::HotChannelTemperature: return "hotChannelTemperature";
+        case ScalarSignal::CoreVoidFraction: return "coreVoidFraction";
+        case ScalarSignal::SteamPower: return "steamPower";
+        case ScalarSignal::CoolantInventory: return "coolantInventory";
+        case ScalarSignal::PressurizerLevel: return "pressurizerLevel";
+        default: return "unknown";
+    }
+}
+
+inline double getSignalValue(const PlantTelemetry& telemetry, ScalarSignal signal) {
+    switch (signal) {
+        case ScalarSignal::SimTime: return telemetry.simTime;
+        case ScalarSignal::MaxCoreTemperature: return telemetry.maxCoreTemperature;
+        case ScalarSignal::TotalPower: return telemetry.totalPower;
+        case ScalarSignal::UpperCoolantTemperature: return telemetry.upperCoolantTemperature;
+        case ScalarSignal::LowerCoolantTemperature: return telemetry.lowerCoolantTemperature;
+        case ScalarSignal::ControlRodInsertion: return telemetry.controlRodInsertion;
+        case ScalarSignal::ScramInitiated: return telemetry.scramInitiated ? 1.0 : 0.0;
+        case ScalarSignal::CoolantFlowRate: return telemetry.coolantFlowRate;
+        case ScalarSignal::HotChannelTemperature: return telemetry.hotChannelTemperature;
+        case ScalarSignal::CoreVoidFraction: return telemetry.coreVoidFraction;
+        case ScalarSignal::SteamPower: return telemetry.steamPower;
+        case ScalarSignal::CoolantInventory: return telemetry.coolantInventory;
+        case ScalarSignal::PressurizerLevel: return telemetry.pressurizerLevel;
+        default: return 0.0;
+    }
+}
+
+inline const char* getSignalName(FieldSignal signal) {
+    switch (signal) {
+        case FieldSignal::CoreTemperature: return "coreTemperature";
+        case FieldSignal::NeutronPopulation: return "neutronPopulation";
+        case FieldSignal::NeutronFlux: return "neutronFlux";
+        case FieldSignal::CoolantTemperature: return "coolantTemperature";
+        default: return "unknown";
+    }
+}
+
+#endif // TELEMETRYFORMAT_H
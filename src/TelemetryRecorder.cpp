@@ -0,0 +1,302 @@
+// TelemetryRecorder.cpp
+
+#include "TelemetryRecorder.h"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include "Core.h"
+#include "CoolantSystem.h"
+
+namespace {
+
+template <typename T>
+void writeValue(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void writeArray(std::ofstream& out, const std::vector<T>& values) {
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+void writeName(std::ofstream& out, const char* name) {
+    std::string s(name);
+    writeValue(out, static_cast<std::uint16_t>(s.size()));
+    out.write(s.data(), static_cast<std::streamsize>(s.size()));
+}
+
+} // namespace
+
+RecorderConfig RecorderConfig::allSignals(const std::string& path) {
+    RecorderConfig config;
+    config.path = path;
+    for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(ScalarSignal::Count); ++i) {
+        config.scalars.push_back(static_cast<ScalarSignal>(i));
+    }
+    for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(FieldSignal::Count); ++i) {
+        config.fields.push_back(static_cast<FieldSignal>(i));
+    }
+    return config;
+}
+
+bool TelemetryRecorder::parseSignals(const std::string& list, RecorderConfig& config) {
+    config.scalars.clear();
+    config.fields.clear();
+
+    std::stringstream stream(list);
+    std::string name;
+    while (std::getline(stream, name, ',')) {
+        bool found = false;
+        for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(ScalarSignal::Count) && !found; ++i) {
+            if (name == getSignalName(static_cast<ScalarSignal>(i))) {
+                config.scalars.push_back(static_cast<ScalarSignal>(i));
+                found = true;
+            }
+        }
+        for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(FieldSignal::Count) && !found; ++i) {
+            if (name == getSignalName(static_cast<FieldSignal>(i))) {
+                config.fields.push_back(static_cast<FieldSignal>(i));
+                found = true;
+            }
+        }
+        if (!found) {
+            std::cerr << "Unknown telemetry signal: " << name << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+TelemetryRecorder::TelemetryRecorder(const RecorderConfig& config, const Core& core, const CoolantSystem& coolantSystem)
+    : config(config),
+      fieldSampleSize(0),
+      open(false),
+      spareBuffer(nullptr),
+      samples(queueCapacity),
+      freeBuffers(fieldBufferCount),
+      stopping(false),
+      droppedSamples(0) {
+    // Field sizes are fixed for the whole recording
+    std::size_t cellCount = core.getElements().size();
+    for (FieldSignal field : config.fields) {
+        std::size_t size = 0;
+        switch (field) {
+            case FieldSignal::CoreTemperature:
+            case FieldSignal::NeutronPopulation:
+                size = cellCount;
+                break;
+            case FieldSignal::NeutronFlux:
+                size = cellCount * numEnergyGroups;
+                break;
+            case FieldSignal::CoolantTemperature:
+                size = static_cast<std::size_t>(coolantSystem.getLoopCount()) * coolantSystem.getChunksPerLoop();
+                break;
+            default:
+                break;
+        }
+        fieldSizes.push_back(size);
+        fieldSampleSize += size;
+    }
+
+    out.open(config.path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Failed to open telemetry recording " << config.path << std::endl;
+        return;
+    }
+    open = true;
+    writeHeader();
+
+    // Preallocate field buffers so the simulation thread never allocates
+    if (!config.fields.empty()) {
+        fieldBuffers.resize(fieldBufferCount);
+        for (auto& buffer : fieldBuffers) {
+            buffer.resize(fieldSampleSize);
+            freeBuffers.tryPush(&buffer);
+        }
+    }
+
+    scalarColumns.resize(config.scalars.size());
+    fieldColumns.resize(config.fields.size());
+
+    writerThread = std::thread(&TelemetryRecorder::writerLoop, this);
+}
+
+TelemetryRecorder::~TelemetryRecorder() {
+    stopping.store(true);
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+}
+
+void TelemetryRecorder::writeHeader() {
+    out.write(telemetryMagic, sizeof(telemetryMagic));
+    writeValue(out, telemetryVersion);
+
+    writeValue(out, static_cast<std::uint32_t>(config.scalars.size()));
+    for (ScalarSignal scalar : config.scalars) {
+        writeName(out, getSignalName(scalar));
+    }
+
+    writeValue(out, static_cast<std::uint32_t>(config.fields.size()));
+    for (std::size_t f = 0; f < config.fields.size(); ++f) {
+        writeName(out, getSignalName(config.fields[f]));
+        writeValue(out, static_cast<std::uint32_t>(fieldSizes[f]));
+    }
+
+    writeValue(out, static_cast<std::uint32_t>(config.fieldDecimation));
+}
+
+void TelemetryRecorder::record(const PlantTelemetry& telemetry, const Core& core, const CoolantSystem& coolantSystem) {
+    if (!open) {
+        return;
+    }
+
+    Sample sample{};
+    sample.step = telemetry.step;
+    for (ScalarSignal scalar : config.scalars) {
+        sample.scalars[static_cast<std::size_t>(scalar)] = getSignalValue(telemetry, scalar);
+    }
+    sample.fields = nullptr;
+
+    if (!config.fields.empty() && config.fieldDecimation > 0 && telemetry.step % config.fieldDecimation == 0) {
+        std::vector<double>* buffer = spareBuffer;
+        spareBuffer = nullptr;
+        if (buffer || freeBuffers.tryPop(buffer)) {
+            gatherFields(core, coolantSystem, *buffer);
+            sample.fields = buffer;
+        } else {
+            droppedSamples.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    if (!samples.tryPush(sample)) {
+        droppedSamples.fetch_add(1, std::memory_order_relaxed);
+        // Only the writer may push to freeBuffers; keep the buffer for the next field sample
+        spareBuffer = sample.fields;
+    }
+}
+
+void TelemetryRecorder::gatherFields(const Core& core, const CoolantSystem& coolantSystem, std::vector<double>& buffer) const {
+    double* values = buffer.data();
+
+    for (std::size_t f = 0; f < config.fields.size(); ++f) {
+        switch (config.fields[f]) {
+            case FieldSignal::CoreTemperature: {
+                std::lock_guard<std::mutex> lock(core.getMutex());
+                for (const auto& element : core.getElements()) {
+                    *values++ = element.getTemperature();
+                }
+                break;
+            }
+            case FieldSignal::NeutronPopulation: {
+                std::lock_guard<std::mutex> lock(core.getMutex());
+                for (const auto& element : core.getElements()) {
+                    *values++ = element.getNeutronPopulation();
+                }
+                break;
+            }
+            case FieldSignal::NeutronFlux: {
+                std::lock_guard<std::mutex> lock(core.getMutex());
+                for (int g = 0; g < numEnergyGroups; ++g) {
+                    for (const auto& element : core.getElements()) {
+                        *values++ = element.getNeutronFlux(g);
+                    }
+                }
+                break;
+            }
+            case FieldSignal::CoolantTemperature: {
+                // Loop after loop; a drained loop reads NaN
+                const auto chunksPerLoop = static_cast<std::size_t>(coolantSystem.getChunksPerLoop());
+                for (int loop = 0; loop < coolantSystem.getLoopCount(); ++loop) {
+                    const CoolantLoop& coolantLoop = coolantSystem.getLoop(loop);
+                    std::lock_guard<std::mutex> lock(coolantLoop.getMutex());
+                    for (std::size_t i = 0; i < chunksPerLoop; ++i) {
+                        *values++ = coolantLoop.getTemperature(i);
+                    }
+                }
+                break;
+            }
+            default:
+                values += fieldSizes[f];
+                break;
+        }
+    }
+}
+
+void TelemetryRecorder::writerLoop() {
+    while (true) {
+        Sample sample{};
+        bool any = false;
+        while (samples.tryPop(sample)) {
+            consume(sample);
+            any = true;
+        }
+
+        if (!any) {
+            if (stopping.load()) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    flushScalars();
+    flushFields();
+    out.flush();
+}
+
+void TelemetryRecorder::consume(const Sample& sample) {
+    if (!config.scalars.empty()) {
+        scalarSteps.push_back(sample.step);
+        for (std::size_t c = 0; c < config.scalars.size(); ++c) {
+            scalarColumns[c].push_back(sample.scalars[static_cast<std::size_t>(config.scalars[c])]);
+        }
+        if (scalarSteps.size() >= static_cast<std::size_t>(config.chunkRows)) {
+            flushScalars();
+        }
+    }
+
+    if (sample.fields) {
+        fieldSteps.push_back(sample.step);
+        const double* in = sample.fields->data();
+        for (std::size_t f = 0; f < config.fields.size(); ++f) {
+            fieldColumns[f].insert(fieldColumns[f].end(), in, in + fieldSizes[f]);
+            in += fieldSizes[f];
+        }
+        freeBuffers.tryPush(sample.fields);
+
+        if (fieldSteps.size() >= static_cast<std::size_t>(config.fieldChunkRows)) {
+            flushFields();
+        }
+    }
+}
+
+void TelemetryRecorder::flushScalars() {
+    if (scalarSteps.empty()) {
+        return;
+    }
+
+    writeValue(out, static_cast<std::uint32_t>(TelemetryChunkType::Scalars));
+    writeValue(out, static_cast<std::uint32_t>(scalarSteps.size()));
+    writeArray(out, scalarSteps);
+    for (auto& column : scalarColumns) {
+        writeArray(out, column);
+        column.clear();
+    }
+    scalarSteps.clear();
+}
+
+void TelemetryRecorder::flushFields() {
+    if (fieldSteps.empty()) {
+        return;
+    }
+
+    writeValue(out, static_cast<std::uint32_t>(TelemetryChunkType::Fields));
+    writeValue(out, static_cast<std::uint32_t>(fieldSteps.size()));
+    writeArray(out, fieldSteps);
+    for (auto& column : fieldColumns) {
+        writeArray(out, column);
+        column.clear();
+    }
+    fieldSteps.clear();
+}
@@ -0,0 +1,95 @@
+// TelemetryRecorder.h
+
+#ifndef TELEMETRYRECORDER_H
+#define TELEMETRYRECORDER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "PlantTelemetry.h"
+#include "SpscQueue.h"
+#include "TelemetryFormat.h"
+
+class Core;
+class CoolantSystem;
+
+struct RecorderConfig {
+    std::string path;
+    std::vector<ScalarSignal> scalars;  // Scalar signals recorded every step
+    std::vector<FieldSignal> fields;    // Per-cell fields recorded every fieldDecimation steps
+    int fieldDecimation = 30;
+    int chunkRows = 1024;               // Scalar rows per chunk
+    int fieldChunkRows = 8;             // Field samples per chunk
+
+    // Every signal, with fields at the default decimation
+    static RecorderConfig allSignals(const std::string& path);
+};
+
+// Records plant signals to a columnar, chunked binary file (see TelemetryFormat.h).
+//
+// The simulation thread only copies values into a lock-free queue; per-cell fields go
+// into preallocated buffers that the writer thread hands back once written. If the
+// writer falls behind, samples are dropped rather than blocking the simulation.
+class TelemetryRecorder {
+public:
+    TelemetryRecorder(const RecorderConfig& config, const Core& core, const CoolantSystem& coolantSystem);
+    ~TelemetryRecorder();
+
+    TelemetryRecorder(const TelemetryRecorder&) = delete;
+    TelemetryRecorder& operator=(const TelemetryRecorder&) = delete;
+
+    [[nodiscard]] bool isOpen() const { return open; }
+
+    // Called from the simulation thread once per step
+    void record(const PlantTelemetry& telemetry, const Core& core, const CoolantSystem& coolantSystem);
+
+    [[nodiscard]] std::uint64_t getDroppedSamples() const { return droppedSamples.load(); }
+
+    // Parses a comma separated list of signal names into config.scalars / config.fields
+    static bool parseSignals(const std::string& list, RecorderConfig& config);
+
+private:
+    static constexpr std::size_t queueCapacity = 4096;
+    static constexpr std::size_t fieldBufferCount = 16;
+
+    struct Sample {
+        std::uint64_t step;
+        std::array<double, static_cast<std::size_t>(ScalarSignal::Count)> scalars;
+        std::vector<double>* fields; // nullptr when no field sample was taken this step
+    };
+
+    RecorderConfig config;
+    std::vector<std::size_t> fieldSizes;
+    std::size_t fieldSampleSize;
+    bool open;
+
+    std::vector<std::vector<double>> fieldBuffers;
+    std::vector<double>* spareBuffer;
+    SpscQueue<Sample> samples;
+    SpscQueue<std::vector<double>*> freeBuffers;
+    std::atomic<bool> stopping;
+    std::atomic<std::uint64_t> droppedSamples;
+
+    // Writer thread state
+    std::ofstream out;
+    std::vector<std::uint64_t> scalarSteps;
+    std::vector<std::vector<double>> scalarColumns;
+    std::vector<std::uint64_t> fieldSteps;
+    std::vector<std::vector<double>> fieldColumns;
+
+    std::thread writerThread;
+
+    void writeHeader();
+    void writerLoop();
+    void consume(const Sample& sample);
+    void flushScalars();
+    void flushFields();
+    void gatherFields(const Core& core, const CoolantSystem& coolantSystem, std::vector<double>& buffer) const;
+};
+
+#endif // TELEMETRYRECORDER_H
@@ -0,0 +1,139 @@
+// TridiagonalBenchmark.cpp
+//
+// Throughput of the tridiagonal solvers in TridiagonalSolver.h.
+//
+//   TridiagonalBenchmark [--length N] [--systems M] [--threads T] [--repeats R]
+//
+// Builds M diagonally dominant systems of N rows, the shape of one family of core grid lines,
+// and solves them three ways: the scalar Thomas loop one system at a time, the batched solver
+// over the whole interleaved set, and the batched solver shared out over a worker pool in
+// blocks. Prints the time per row of each and its largest deviation from the scalar solution.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "TridiagonalSolver.h"
+#include "WorkerPool.h"
+
+namespace {
+
+constexpr std::size_t systemsPerBlock = 64;
+
+// Interleaved systems: row k of system s at k * systems + s
+struct Batch {
+    std::vector<double> lower, diagonal, upper, rhs;
+};
+
+template <typename Solve>
+double timeSolves(const Batch& pristine, Batch& work, int repeats, Solve solve) {
+    double seconds = 0.0;
+    for (int r = 0; r < repeats; ++r) {
+        work = pristine;
+        auto start = std::chrono::steady_clock::now();
+        solve(work);
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return seconds;
+}
+
+double maxDeviation(const std::vector<double>& a, const std::vector<double>& b) {
+    double deviation = 0.0;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        deviation = std::max(deviation, std::abs(a[i] - b[i]) / std::max(std::abs(b[i]), 1e-300));
+    }
+    return deviation;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::size_t length = 64;
+    std::size_t systems = 4096;
+    std::size_t threads = 0;
+    int repeats = 20;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--length" && i + 1 < argc) {
+            length = std::max<std::size_t>(1, std::stoul(argv[++i]));
+        } else if (arg == "--systems" && i + 1 < argc) {
+            systems = std::max<std::size_t>(1, std::stoul(argv[++i]));
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::stoul(argv[++i]);
+        } else if (arg == "--repeats" && i + 1 < argc) {
+            repeats = std::max(1, std::stoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--length N] [--systems M] [--threads T] [--repeats R]" << std::endl;
+            return 1;
+        }
+    }
+
+    // Conduction-like systems: negative off-diagonals and a dominant diagonal
+    Batch pristine;
+    const std::size_t values = length * systems;
+    pristine.lower.resize(values);
+    pristine.diagonal.resize(values);
+    pristine.upper.resize(values);
+    pristine.rhs.resize(values);
+    std::mt19937_64 random(12345);
+    std::uniform_real_distribution<double> coupling(0.0, 1.0);
+    std::uniform_real_distribution<double> source(-1.0, 1.0);
+    for (std::size_t i = 0; i < values; ++i) {
+        pristine.lower[i] = i < systems ? 0.0 : -coupling(random);
+        pristine.upper[i] = i + systems >= values ? 0.0 : -coupling(random);
+        pristine.diagonal[i] = 1.0 + coupling(random) - pristine.lower[i] - pristine.upper[i];
+        pristine.rhs[i] = source(random);
+    }
+
+    // Scalar: each system copied out to contiguous rows and solved on its own
+    Batch work;
+    std::vector<double> scalarSolution(values);
+    std::vector<double> lower(length), diagonal(length), upper(length), rhs(length);
+    double scalarSeconds = timeSolves(pristine, work, repeats, [&](Batch& batch) {
+        for (std::size_t s = 0; s < systems; ++s) {
+            for (std::size_t k = 0; k < length; ++k) {
+                lower[k] = batch.lower[k * systems + s];
+                diagonal[k] = batch.diagonal[k * systems + s];
+                upper[k] = batch.upper[k * systems + s];
+                rhs[k] = batch.rhs[k * systems + s];
+            }
+            solveTridiagonal(lower, diagonal, upper, rhs);
+            for (std::size_t k = 0; k < length; ++k) {
+                batch.rhs[k * systems + s] = rhs[k];
+            }
+        }
+    });
+    scalarSolution = work.rhs;
+
+    double batchedSeconds = timeSolves(pristine, work, repeats, [&](Batch& batch) {
+        solveTridiagonalBatch(systems, batch.lower, batch.diagonal, batch.upper, batch.rhs);
+    });
+    double batchedDeviation = maxDeviation(work.rhs, scalarSolution);
+
+    WorkerPool pool(threads);
+    const std::size_t blockCount = (systems + systemsPerBlock - 1) / systemsPerBlock;
+    double pooledSeconds = timeSolves(pristine, work, repeats, [&](Batch& batch) {
+        pool.parallelFor(blockCount, [&](std::size_t block) {
+            const std::size_t first = block * systemsPerBlock;
+            solveTridiagonalBatch(systems, first, std::min(first + systemsPerBlock, systems), batch.lower,
+                                  batch.diagonal, batch.upper, batch.rhs);
+        });
+    });
+    double pooledDeviation = maxDeviation(work.rhs, scalarSolution);
+
+    const double rows = static_cast<double>(values) * repeats;
+    std::cout << systems << " systems of " << length << " rows, " << repeats << " repeats\n"
+              << " - Scalar:  " << scalarSeconds / rows * 1e9 << " ns/row\n"
+              << " - Batched: " << batchedSeconds / rows * 1e9 << " ns/row (max deviation " << batchedDeviation
+              << ")\n"
+              << " - Pooled:  " << pooledSeconds / rows * 1e9 << " ns/row on " << pool.getThreadCount()
+              << " threads (max deviation " << pooledDeviation << ")" << std::endl;
+    return 0;
+}
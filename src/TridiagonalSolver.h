@@ -0,0 +1,87 @@
+// TridiagonalSolver.h
+
+#ifndef TRIDIAGONALSOLVER_H
+#define TRIDIAGONALSOLVER_H
+
+#include <cstddef>
+#include <span>
+
+// Solves a tridiagonal system with the Thomas algorithm. Row i reads
+//
+//   lower[i] * x[i - 1] + diagonal[i] * x[i] + upper[i] * x[i + 1] = rhs[i]
+//
+// with lower[0] and upper[n - 1] ignored. There is no pivoting: the implicit physics that
+// builds these systems makes them diagonally dominant. diagonal is overwritten with the
+// eliminated pivots and rhs with the solution.
+inline void solveTridiagonal(std::span<const double> lower, std::span<double> diagonal, std::span<const double> upper,
+                             std::span<double> rhs) {
+    const std::size_t n = rhs.size();
+    if (n == 0) {
+        return;
+    }
+
+    // Forward elimination
+    for (std::size_t i = 1; i < n; ++i) {
+        const double factor = lower[i] / diagonal[i - 1];
+        diagonal[i] -= factor * upper[i - 1];
+        rhs[i] -= factor * rhs[i - 1];
+    }
+
+    // Back substitution
+    rhs[n - 1] /= diagonal[n - 1];
+    for (std::size_t i = n - 1; i-- > 0;) {
+        rhs[i] = (rhs[i] - upper[i] * rhs[i + 1]) / diagonal[i];
+    }
+}
+
+// Solves a batch of independent systems of the same size stored interleaved, structure of
+// arrays: row k of system s sits at k * batch + s in each array, as the cells of neighbouring
+// grid lines or BatchedCore lanes do. The elimination steps down the rows and runs across the
+// systems in the inner loop, so each row is a vector operation over the batch. Only systems
+// [first, last) are solved, which lets callers share one batch out over threads.
+inline void solveTridiagonalBatch(std::size_t batch, std::size_t first, std::size_t last,
+                                  std::span<const double> lower, std::span<double> diagonal,
+                                  std::span<const double> upper, std::span<double> rhs) {
+    const std::size_t n = batch > 0 ? rhs.size() / batch : 0;
+    if (n == 0 || first >= last) {
+        return;
+    }
+    const double* lowerRows = lower.data();
+    const double* upperRows = upper.data();
+    double* diagonalRows = diagonal.data();
+    double* rhsRows = rhs.data();
+
+    // Forward elimination
+    for (std::size_t i = 1; i < n; ++i) {
+        const std::size_t row = i * batch;
+        const std::size_t previous = row - batch;
+#pragma omp simd
+        for (std::size_t s = first; s < last; ++s) {
+            const double factor = lowerRows[row + s] / diagonalRows[previous + s];
+            diagonalRows[row + s] -= factor * upperRows[previous + s];
+            rhsRows[row + s] -= factor * rhsRows[previous + s];
+        }
+    }
+
+    // Back substitution
+    const std::size_t lastRow = (n - 1) * batch;
+#pragma omp simd
+    for (std::size_t s = first; s < last; ++s) {
+        rhsRows[lastRow + s] /= diagonalRows[lastRow + s];
+    }
+    for (std::size_t i = n - 1; i-- > 0;) {
+        const std::size_t row = i * batch;
+        const std::size_t next = row + batch;
+#pragma omp simd
+        for (std::size_t s = first; s < last; ++s) {
+            rhsRows[row + s] = (rhsRows[row + s] - upperRows[row + s] * rhsRows[next + s]) / diagonalRows[row + s];
+        }
+    }
+}
+
+inline void solveTridiagonalBatch(std::size_t batch, std::span<const double> lower, std::span<double> diagonal,
+                                  std::span<const double> upper, std::span<double> rhs) {
+    solveTridiagonalBatch(batch, 0, batch, lower, diagonal, upper, rhs);
+}
+
+#endif // TRIDIAGONALSOLVER_H
@@ -49,12 +49,11 @@ void main()
 }
 )glsl";
 
-Visualization::Visualization(Core& core, CoolantLoop& coolantLoop, std::atomic<bool>& running)
+Visualization::Visualization(Core& core, CoolantSystem& coolantSystem, std::atomic<bool>& running)
     : core(core),
-      coolantLoop(coolantLoop),
+      coolantSystem(coolantSystem),
       running(running),
       coreMutex(core.getMutex()),
-      coolantMutex(coolantLoop.getMutex()),
       window(nullptr),
       shaderProgram(0),
       VAO_core(0),
@@ -330,47 +329,44 @@ void Visualization::drawCore() {
 void Visualization::drawCoolantLoop() {
     // Variables to store copied data
     std::vector<double> temperatures;
-    int chunkCount;
-
-    // Acquire lock and copy necessary data
-    {
-        std::lock_guard<std::mutex> lock(coolantMutex);
-        const auto& chunks = coolantLoop.getChunks();
-        chunkCount = chunks.size();
-        temperatures.reserve(chunkCount);
-
-        for (const auto& chunk : chunks) {
-            temperatures.push_back(chunk.getTemperature());
-        }
-    } // Lock is released here
-
-    // Now use the copied temperatures for rendering
     std::vector<float> vertices; // x, y, value
 
     double minTemp = std::numeric_limits<double>::max();
     double maxTemp = std::numeric_limits<double>::lowest();
 
-    int index = 0;
-    for (const auto& temp : temperatures) {
-        minTemp = std::min(minTemp, temp);
-        maxTemp = std::max(maxTemp, temp);
+    // Each loop is drawn as its own ring, loop 0 outermost
+    for (int loop = 0; loop < coolantSystem.getLoopCount(); ++loop) {
+        // Acquire this loop's lock and copy its temperatures
+        {
+            const CoolantLoop& coolantLoop = coolantSystem.getLoop(loop);
+            std::lock_guard<std::mutex> lock(coolantLoop.getMutex());
+            coolantLoop.copyTemperatures(temperatures);
+        } // Lock is released here
+
+        const int chunkCount = static_cast<int>(temperatures.size());
+        const float radius = 0.8f - 0.1f * static_cast<float>(loop); // Radius of the loop
 
-        // Normalize temperature value
-        float normalizedValue = static_cast<float>((temp - 300.0) / (600.0 - 300.0));
-        normalizedValue = std::clamp(normalizedValue, 0.0f, 1.0f);
+        int index = 0;
+        for (const auto& temp : temperatures) {
+            minTemp = std::min(minTemp, temp);
+            maxTemp = std::max(maxTemp, temp);
+
+            // Normalize temperature value
+            float normalizedValue = static_cast<float>((temp - 300.0) / (600.0 - 300.0));
+            normalizedValue = std::clamp(normalizedValue, 0.0f, 1.0f);
 
-        // Arrange positions in a circular loop
-        float angle = (static_cast<float>(index) / chunkCount) * 2.0f * 3.1415926f; // Angle in radians
-        float radius = 0.8f; // Radius of the loop
+            // Arrange positions in a circular loop
+            float angle = (static_cast<float>(index) / chunkCount) * 2.0f * 3.1415926f; // Angle in radians
 
-        float normX = radius * cos(angle);
-        float normY = radius * sin(angle);
+            float normX = radius * cos(angle);
+            float normY = radius * sin(angle);
 
-        vertices.push_back(normX);
-        vertices.push_back(normY);
-        vertices.push_back(normalizedValue);
+            vertices.push_back(normX);
+            vertices.push_back(normY);
+            vertices.push_back(normalizedValue);
 
-        index++;
+            index++;
+        }
     }
 
     // Log temperature range
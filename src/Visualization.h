@@ -6,7 +6,7 @@ class Core;
 #include <thread>
 #include <atomic>
 #include <mutex>
-#include "CoolantLoop.h"
+#include "CoolantSystem.h"
 
 // Include OpenGL and GLFW headers
 #include <glad/glad.h>
@@ -18,7 +18,7 @@ class Core;
 
 class Visualization {
 public:
-    Visualization(Core& core, CoolantLoop& coolantLoop, std::atomic<bool>& running);
+    Visualization(Core& core, CoolantSystem& coolantSystem, std::atomic<bool>& running);
     ~Visualization();
 
     void start();
@@ -27,14 +27,13 @@ private:
     void renderLoop();
 
     Core& core;
-    CoolantLoop& coolantLoop;
+    CoolantSystem& coolantSystem;
     std::atomic<bool>& running;
 
     GLFWwindow* window;
 
     // Synchronization
-    std::mutex& coreMutex;
-    std::mutex& coolantMutex;
+    std::mutex& coreMutex; // Coolant loops are locked one at a time through coolantSystem
 
     // OpenGL-related
     GLuint shaderProgram;
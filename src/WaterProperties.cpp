@@ -0,0 +1,419 @@
+// WaterProperties.cpp
+
+#include "WaterProperties.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+
+constexpr double gasConstant = 461.526; // J/(kg K), IF97 specific gas constant
+
+// Region 1 (compressed liquid): dimensionless Gibbs energy
+// gamma = sum n (7.1 - pi)^I (tau - 1.222)^J, pi = p / 16.53 MPa, tau = 1386 K / T
+struct Term {
+    int i;
+    int j;
+    double n;
+};
+
+constexpr std::array<Term, 34> region1 = {{
+    {0, -2, 0.14632971213167},     {0, -1, -0.84548187169114},    {0, 0, -0.37563603672040e1},
+    {0, 1, 0.33855169168385e1},    {0, 2, -0.95791963387872},     {0, 3, 0.15772038513228},
+    {0, 4, -0.16616417199501e-1},  {0, 5, 0.81214629983568e-3},   {1, -9, 0.28319080123804e-3},
+    {1, -7, -0.60706301565874e-3}, {1, -1, -0.18990068218419e-1}, {1, 0, -0.32529748770505e-1},
+    {1, 1, -0.21841717175414e-1},  {1, 3, -0.52838357969930e-4},  {2, -3, -0.47184321073267e-3},
+    {2, 0, -0.30001780793026e-3},  {2, 1, 0.47661393906987e-4},   {2, 3, -0.44141845330846e-5},
+    {2, 17, -0.72694996297594e-15}, {3, -4, -0.31679644845054e-4}, {3, 0, -0.28270797985312e-5},
+    {3, 6, -0.85205128120103e-9},  {4, -5, -0.22425281908000e-5}, {4, -2, -0.65171222895601e-6},
+    {4, 10, -0.14341729937924e-12}, {5, -8, -0.40516996860117e-6}, {8, -11, -0.12734301741641e-8},
+    {8, -6, -0.17424871230634e-9}, {21, -29, -0.68762131295531e-18}, {23, -31, 0.14478307828521e-19},
+    {29, -38, 0.26335781662795e-22}, {30, -39, -0.11947622640071e-22}, {31, -40, 0.18228094581404e-23},
+    {32, -41, -0.93537087292458e-25},
+}};
+
+// Region 2 (vapour): ideal-gas part sum n tau^J plus ln(pi), and residual part
+// sum n pi^I (tau - 0.5)^J, pi = p / 1 MPa, tau = 540 K / T
+constexpr std::array<Term, 9> region2Ideal = {{
+    {0, 0, -0.96927686500217e1}, {0, 1, 0.10086655968018e2},  {0, -5, -0.56087911283020e-2},
+    {0, -4, 0.71452738081455e-1}, {0, -3, -0.40710498223928}, {0, -2, 0.14240819171444e1},
+    {0, -1, -0.43839511319450e1}, {0, 2, -0.28408632460772},  {0, 3, 0.21268463753307e-1},
+}};
+
+constexpr std::array<Term, 43> region2Residual = {{
+    {1, 0, -0.17731742473213e-2},  {1, 1, -0.17834862292358e-1},  {1, 2, -0.45996013696365e-1},
+    {1, 3, -0.57581259083432e-1},  {1, 6, -0.50325278727930e-1},  {2, 1, -0.33032641670203e-4},
+    {2, 2, -0.18948987516315e-3},  {2, 4, -0.39392777243355e-2},  {2, 7, -0.43797295650573e-1},
+    {2, 36, -0.26674547914087e-4}, {3, 0, 0.20481737692309e-7},   {3, 1, 0.43870667284435e-6},
+    {3, 3, -0.32277677238570e-4},  {3, 6, -0.15033924542148e-2},  {3, 35, -0.40668253562649e-1},
+    {4, 1, -0.78847309559367e-9},  {4, 2, 0.12790717852285e-7},   {4, 3, 0.48225372718507e-6},
+    {5, 7, 0.22922076337661e-5},   {6, 3, -0.16714766451061e-10}, {6, 16, -0.21171472321355e-2},
+    {6, 35, -0.23895741934104e2},  {7, 0, -0.59059564324270e-17}, {7, 11, -0.12621808899101e-5},
+    {7, 25, -0.38946842435739e-1}, {8, 8, 0.11256211360459e-10},  {8, 36, -0.82311340897998e1},
+    {9, 13, 0.19809712802088e-7},  {10, 4, 0.10406965210174e-18}, {10, 10, -0.10234747095929e-12},
+    {10, 14, -0.10018179379511e-8}, {16, 29, -0.80882908646985e-10}, {16, 50, 0.10693031879409},
+    {18, 57, -0.33662250574171},   {20, 20, 0.89185845355421e-24}, {20, 35, 0.30629316876232e-12},
+    {20, 48, -0.42002467698208e-5}, {21, 21, -0.59056029685639e-25}, {22, 53, 0.37826947613457e-5},
+    {23, 39, -0.12768608934681e-14}, {24, 26, 0.73087610595061e-28}, {24, 40, 0.55414715350778e-16},
+    {24, 58, -0.94369707241210e-6},
+}};
+
+// Region 4 (saturation line)
+constexpr std::array<double, 10> region4 = {
+    0.11670521452767e4,  -0.72421316703206e6, -0.17073846940092e2, 0.12020824702470e5,
+    -0.32325550322333e7, 0.14915108613530e2,  -0.48232657361591e4, 0.40511340542057e6,
+    -0.23855557567849,   0.65017534844798e3,
+};
+
+// Derivatives of a Gibbs energy with respect to pi and tau
+struct Gibbs {
+    double gammaPi = 0.0;
+    double gammaTau = 0.0;
+    double gammaTauTau = 0.0;
+};
+
+Gibbs region1Gibbs(double pi, double tau) {
+    Gibbs g;
+    const double a = 7.1 - pi;
+    const double b = tau - 1.222;
+    for (const Term& t : region1) {
+        g.gammaPi += -t.n * t.i * std::pow(a, t.i - 1) * std::pow(b, t.j);
+        g.gammaTau += t.n * std::pow(a, t.i) * t.j * std::pow(b, t.j - 1);
+        g.gammaTauTau += t.n * std::pow(a, t.i) * t.j * (t.j - 1) * std::pow(b, t.j - 2);
+    }
+    return g;
+}
+
+Gibbs region2Gibbs(double pi, double tau) {
+    Gibbs g;
+    g.gammaPi = 1.0 / pi;
+    for (const Term& t : region2Ideal) {
+        g.gammaTau += t.n * t.j * std::pow(tau, t.j - 1);
+        g.gammaTauTau += t.n * t.j * (t.j - 1) * std::pow(tau, t.j - 2);
+    }
+    const double b = tau - 0.5;
+    for (const Term& t : region2Residual) {
+        g.gammaPi += t.n * t.i * std::pow(pi, t.i - 1) * std::pow(b, t.j);
+        g.gammaTau += t.n * std::pow(pi, t.i) * t.j * std::pow(b, t.j - 1);
+        g.gammaTauTau += t.n * std::pow(pi, t.i) * t.j * (t.j - 1) * std::pow(b, t.j - 2);
+    }
+    return g;
+}
+
+// IAPWS 2008 viscosity without the critical enhancement (outside the tabulated range)
+double viscosity(double density, double temperature) {
+    constexpr std::array<double, 4> h0 = {1.67752, 2.20462, 0.6366564, -0.241605};
+    constexpr double h1[6][7] = {
+        {5.20094e-1, 2.22531e-1, -2.81378e-1, 1.61913e-1, -3.25372e-2, 0.0, 0.0},
+        {8.50895e-2, 9.99115e-1, -9.06851e-1, 2.57399e-1, 0.0, 0.0, 0.0},
+        {-1.08374, 1.88797, -7.72479e-1, 0.0, 0.0, 0.0, 0.0},
+        {-2.89555e-1, 1.26613, -4.89837e-1, 0.0, 6.98452e-2, 0.0, -4.35673e-3},
+        {0.0, 0.0, -2.57040e-1, 0.0, 0.0, 8.72102e-3, 0.0},
+        {0.0, 1.20573e-1, 0.0, 0.0, 0.0, 0.0, -5.93264e-4},
+    };
+
+    const double t = temperature / 647.096;
+    const double d = density / 322.0;
+
+    double sum0 = 0.0;
+    for (int i = 0; i < 4; ++i) {
+        sum0 += h0[i] / std::pow(t, i);
+    }
+    const double mu0 = 100.0 * std::sqrt(t) / sum0;
+
+    double sum1 = 0.0;
+    for (int i = 0; i < 6; ++i) {
+        for (int j = 0; j < 7; ++j) {
+            sum1 += h1[i][j] * std::pow(1.0 / t - 1.0, i) * std::pow(d - 1.0, j);
+        }
+    }
+    const double mu1 = std::exp(d * sum1);
+
+    return 1.0e-6 * mu0 * mu1;
+}
+
+// IAPWS 2011 thermal conductivity, without the critical enhancement (the tables stay below
+// region 3, where it is a fraction of a percent away from the saturation line)
+double thermalConductivity(double density, double temperature) {
+    constexpr std::array<double, 5> l0 = {2.443221e-3, 1.323095e-2, 6.770357e-3, -3.454586e-3, 4.096266e-4};
+    constexpr double l1[5][6] = {
+        {1.60397357, -0.646013523, 0.111443906, 0.102997357, -0.0504123634, 0.00609859258},
+        {2.33771842, -2.78843778, 1.53616167, -0.463045512, 0.0832827019, -0.00719201245},
+        {2.19650529, -4.54580785, 3.55777244, -1.40944978, 0.275418278, -0.0205938816},
+        {-1.21051378, 1.60812989, -0.621178141, 0.0716373224, 0.0, 0.0},
+        {-2.7203370, 4.57586331, -3.18369245, 1.1168348, -0.19268305, 0.012913842},
+    };
+
+    const double t = temperature / 647.096;
+    const double d = density / 322.0;
+
+    double sum0 = 0.0;
+    for (int i = 0; i < 5; ++i) {
+        sum0 += l0[i] / std::pow(t, i);
+    }
+    const double lambda0 = std::sqrt(t) / sum0;
+
+    double sum1 = 0.0;
+    for (int i = 0; i < 5; ++i) {
+        for (int j = 0; j < 6; ++j) {
+            sum1 += l1[i][j] * std::pow(1.0 / t - 1.0, i) * std::pow(d - 1.0, j);
+        }
+    }
+    const double lambda1 = std::exp(d * sum1);
+
+    return 1.0e-3 * lambda0 * lambda1;
+}
+
+WaterProperties::State gibbsState(const Gibbs& g, double pressure, double temperature, double pi, double tau) {
+    WaterProperties::State state{};
+    state.density = pressure / (gasConstant * temperature * pi * g.gammaPi);
+    state.enthalpy = gasConstant * temperature * tau * g.gammaTau;
+    state.heatCapacity = -gasConstant * tau * tau * g.gammaTauTau;
+    return state;
+}
+
+// Transport properties are left to the caller
+WaterProperties::State liquidState(double pressure, double temperature) {
+    const double pi = pressure / 16.53e6;
+    const double tau = 1386.0 / temperature;
+    return gibbsState(region1Gibbs(pi, tau), pressure, temperature, pi, tau);
+}
+
+WaterProperties::State vapourState(double pressure, double temperature) {
+    const double pi = pressure / 1.0e6;
+    const double tau = 540.0 / temperature;
+    return gibbsState(region2Gibbs(pi, tau), pressure, temperature, pi, tau);
+}
+
+// Table coordinate of value, clamped to [0, count - 1]; NaN lands on the lower edge
+double tableCoordinate(double value, double origin, double step, int count) {
+    return std::min(std::max(0.0, (value - origin) / step), count - 1.0);
+}
+
+// One row of a [pressure][Count] table blended between the two rows around a pressure
+// coordinate. The batched lookups keep one per thread and table, and it is only re-blended
+// when the coordinate changes, so repeated small batches at one pressure skip the blend.
+template <int Count>
+struct BlendedRow {
+    const float* table = nullptr;
+    double coordinate = -1.0;
+    std::array<double, Count> values;
+
+    const std::array<double, Count>& blend(const float* rows, double x, int pressureCount) {
+        if (rows != table || x != coordinate) {
+            const int p = std::min(static_cast<int>(x), pressureCount - 2);
+            const double fp = x - p;
+            const float* low = rows + static_cast<std::size_t>(p) * Count;
+            const float* high = low + Count;
+            for (int k = 0; k < Count; ++k) {
+                values[k] = low[k] + fp * (high[k] - low[k]);
+            }
+            table = rows;
+            coordinate = x;
+        }
+        return values;
+    }
+};
+
+} // namespace
+
+WaterProperties::State WaterProperties::evaluate(double pressure, double temperature) {
+    State state = temperature <= saturationTemperature(pressure) ? liquidState(pressure, temperature)
+                                                                  : vapourState(pressure, temperature);
+    state.viscosity = viscosity(state.density, temperature);
+    state.thermalConductivity = thermalConductivity(state.density, temperature);
+    return state;
+}
+
+WaterProperties::Saturation WaterProperties::evaluateSaturation(double pressure) {
+    Saturation saturation{};
+    saturation.temperature = saturationTemperature(pressure);
+    State liquid = liquidState(pressure, saturation.temperature);
+    State vapour = vapourState(pressure, saturation.temperature);
+    saturation.liquidEnthalpy = liquid.enthalpy;
+    saturation.vapourEnthalpy = vapour.enthalpy;
+    saturation.liquidDensity = liquid.density;
+    saturation.vapourDensity = vapour.density;
+
+    saturation.liquidHeatCapacity = liquid.heatCapacity;
+    saturation.liquidViscosity = viscosity(liquid.density, saturation.temperature);
+    saturation.liquidConductivity = thermalConductivity(liquid.density, saturation.temperature);
+
+    // IAPWS 2014 surface tension
+    const double tau = 1.0 - saturation.temperature / 647.096;
+    saturation.surfaceTension = 235.8e-3 * std::pow(tau, 1.256) * (1.0 - 0.625 * tau);
+    return saturation;
+}
+
+double WaterProperties::saturationPressure(double temperature) {
+    const auto& n = region4;
+    const double theta = temperature + n[8] / (temperature - n[9]);
+    const double a = theta * theta + n[0] * theta + n[1];
+    const double b = n[2] * theta * theta + n[3] * theta + n[4];
+    const double c = n[5] * theta * theta + n[6] * theta + n[7];
+    const double root = 2.0 * c / (-b + std::sqrt(b * b - 4.0 * a * c));
+    return 1.0e6 * root * root * root * root;
+}
+
+double WaterProperties::saturationTemperature(double pressure) {
+    const auto& n = region4;
+    const double beta = std::pow(pressure / 1.0e6, 0.25);
+    const double e = beta * beta + n[2] * beta + n[5];
+    const double f = n[0] * beta * beta + n[3] * beta + n[6];
+    const double g = n[1] * beta * beta + n[4] * beta + n[7];
+    const double d = 2.0 * g / (-f - std::sqrt(f * f - 4.0 * e * g));
+    return 0.5 * (n[9] + d - std::sqrt((n[9] + d) * (n[9] + d) - 4.0 * (n[8] + n[9] * d)));
+}
+
+WaterProperties::WaterProperties() {
+    for (auto& table : tables) {
+        table.resize(static_cast<std::size_t>(pressureCount) * temperatureCount);
+    }
+    temperatureTable.resize(static_cast<std::size_t>(pressureCount) * enthalpyCount);
+    saturationTable.resize(pressureCount);
+
+    std::vector<double> curveEnthalpy;
+    std::vector<double> curveTemperature;
+    for (int p = 0; p < pressureCount; ++p) {
+        const double pressure = minPressure + p * pressureStep;
+        const Saturation saturation = evaluateSaturation(pressure);
+        saturationTable[p] = saturation;
+
+        // h(T) along the row, with the flat two-phase segment at Tsat inserted exactly
+        curveEnthalpy.clear();
+        curveTemperature.clear();
+        for (int t = 0; t < temperatureCount; ++t) {
+            const double temperature = minTemperature + t * temperatureStep;
+            State state = evaluate(pressure, temperature);
+            const std::size_t node = static_cast<std::size_t>(p) * temperatureCount + t;
+            tables[static_cast<int>(Property::Density)][node] = static_cast<float>(state.density);
+            tables[static_cast<int>(Property::HeatCapacity)][node] = static_cast<float>(state.heatCapacity);
+            tables[static_cast<int>(Property::Enthalpy)][node] = static_cast<float>(state.enthalpy);
+            tables[static_cast<int>(Property::Viscosity)][node] = static_cast<float>(state.viscosity);
+            tables[static_cast<int>(Property::ThermalConductivity)][node] =
+                static_cast<float>(state.thermalConductivity);
+
+            if (temperature > saturation.temperature && (t == 0 || temperature - temperatureStep <= saturation.temperature)) {
+                curveEnthalpy.insert(curveEnthalpy.end(), {saturation.liquidEnthalpy, saturation.vapourEnthalpy});
+                curveTemperature.insert(curveTemperature.end(), {saturation.temperature, saturation.temperature});
+            }
+            curveEnthalpy.push_back(state.enthalpy);
+            curveTemperature.push_back(temperature);
+        }
+
+        // Invert it onto the enthalpy grid
+        std::size_t segment = 0;
+        for (int k = 0; k < enthalpyCount; ++k) {
+            const double enthalpy = minEnthalpy + k * enthalpyStep;
+            while (segment + 2 < curveEnthalpy.size() && curveEnthalpy[segment + 1] < enthalpy) {
+                ++segment;
+            }
+            const double h0 = curveEnthalpy[segment];
+            const double h1 = curveEnthalpy[segment + 1];
+            const double f = std::clamp((enthalpy - h0) / (h1 - h0), 0.0, 1.0);
+            temperatureTable[static_cast<std::size_t>(p) * enthalpyCount + k] =
+                static_cast<float>(curveTemperature[segment] + f * (curveTemperature[segment + 1] - curveTemperature[segment]));
+        }
+    }
+}
+
+const WaterProperties& WaterProperties::get() {
+    static const WaterProperties properties;
+    return properties;
+}
+
+double WaterProperties::lookup(Property property, double pressure, double temperature) const {
+    const double x = tableCoordinate(pressure, minPressure, pressureStep, pressureCount);
+    const double y = tableCoordinate(temperature, minTemperature, temperatureStep, temperatureCount);
+    const int p = std::min(static_cast<int>(x), pressureCount - 2);
+    const int t = std::min(static_cast<int>(y), temperatureCount - 2);
+    const double fp = x - p;
+    const double ft = y - t;
+
+    const float* row = table(property) + static_cast<std::size_t>(p) * temperatureCount + t;
+    const double low = row[0] + ft * (row[1] - row[0]);
+    const double high = row[temperatureCount] + ft * (row[temperatureCount + 1] - row[temperatureCount]);
+    return low + fp * (high - low);
+}
+
+void WaterProperties::lookup(Property property, double pressure, std::span<const double> temperatures,
+                             std::span<double> out) const {
+    const std::size_t count = std::min(temperatures.size(), out.size());
+    if (count == 0) {
+        return;
+    }
+
+    // Blend the two pressure rows once for the whole batch, or reuse this thread's last blend
+    thread_local std::array<BlendedRow<temperatureCount>, static_cast<int>(Property::Count)> rows;
+    const double x = tableCoordinate(pressure, minPressure, pressureStep, pressureCount);
+    const auto& row = rows[static_cast<int>(property)].blend(table(property), x, pressureCount);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const double y = tableCoordinate(temperatures[i], minTemperature, temperatureStep, temperatureCount);
+        const int t = std::min(static_cast<int>(y), temperatureCount - 2);
+        const double ft = y - t;
+        out[i] = row[t] + ft * (row[t + 1] - row[t]);
+    }
+}
+
+WaterProperties::Saturation WaterProperties::saturation(double pressure) const {
+    const double x = tableCoordinate(pressure, minPressure, pressureStep, pressureCount);
+    const int p = std::min(static_cast<int>(x), pressureCount - 2);
+    const double fp = x - p;
+
+    const Saturation& low = saturationTable[p];
+    const Saturation& high = saturationTable[p + 1];
+    auto blend = [fp](double a, double b) { return a + fp * (b - a); };
+    return {blend(low.temperature, high.temperature),       blend(low.liquidEnthalpy, high.liquidEnthalpy),
+            blend(low.vapourEnthalpy, high.vapourEnthalpy), blend(low.liquidDensity, high.liquidDensity),
+            blend(low.vapourDensity, high.vapourDensity),   blend(low.surfaceTension, high.surfaceTension),
+            blend(low.liquidHeatCapacity, high.liquidHeatCapacity), blend(low.liquidViscosity, high.liquidViscosity),
+            blend(low.liquidConductivity, high.liquidConductivity)};
+}
+
+namespace {
+
+// Pins the interpolated temperature to the saturation plateau: Tsat between the liquid and
+// vapour enthalpies, at most Tsat below it and at least Tsat above it
+double onSaturationCurve(double temperature, double enthalpy, const WaterProperties::Saturation& saturation) {
+    const double below = std::min(temperature, saturation.temperature);
+    const double above = std::max(temperature, saturation.temperature);
+    return enthalpy < saturation.liquidEnthalpy ? below
+         : enthalpy > saturation.vapourEnthalpy ? above
+                                                : saturation.temperature;
+}
+
+} // namespace
+
+double WaterProperties::temperature(double pressure, double enthalpy) const {
+    const double x = tableCoordinate(pressure, minPressure, pressureStep, pressureCount);
+    const double y = tableCoordinate(enthalpy, minEnthalpy, enthalpyStep, enthalpyCount);
+    const int p = std::min(static_cast<int>(x), pressureCount - 2);
+    const int k = std::min(static_cast<int>(y), enthalpyCount - 2);
+    const double fp = x - p;
+    const double fh = y - k;
+
+    const float* row = temperatureTable.data() + static_cast<std::size_t>(p) * enthalpyCount + k;
+    const double low = row[0] + fh * (row[1] - row[0]);
+    const double high = row[enthalpyCount] + fh * (row[enthalpyCount + 1] - row[enthalpyCount]);
+    return onSaturationCurve(low + fp * (high - low), enthalpy, saturation(pressure));
+}
+
+void WaterProperties::temperatures(double pressure, std::span<const double> enthalpies, std::span<double> out) const {
+    const std::size_t count = std::min(enthalpies.size(), out.size());
+    if (count == 0) {
+        return;
+    }
+
+    thread_local BlendedRow<enthalpyCount> blendedRow;
+    const double x = tableCoordinate(pressure, minPressure, pressureStep, pressureCount);
+    const auto& row = blendedRow.blend(temperatureTable.data(), x, pressureCount);
+    const Saturation curve = saturation(pressure);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const double y = tableCoordinate(enthalpies[i], minEnthalpy, enthalpyStep, enthalpyCount);
+        const int k = std::min(static_cast<int>(y), enthalpyCount - 2);
+        const double fh = y - k;
+        out[i] = onSaturationCurve(row[k] + fh * (row[k + 1] - row[k]), enthalpies[i], curve);
+    }
+}
@@ -0,0 +1,112 @@
+// WaterProperties.h
+
+#ifndef WATERPROPERTIES_H
+#define WATERPROPERTIES_H
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+// Light water and steam properties from IAPWS-IF97 (regions 1, 2 and 4) and the IAPWS 2008
+// viscosity and 2011 thermal conductivity correlations, tabulated once over pressure and
+// temperature.
+//
+// The closed forms cost dozens of pow() calls a point, so the simulation reads them from
+// float tables laid out [pressure][temperature] (one table per property, tens of KB each)
+// with clamped, branch-free bilinear interpolation. The batched lookups take one pressure
+// for a whole array of temperatures: the two bracketing pressure rows are blended once per
+// pressure (each thread keeps its last blend), and the per-element work is a linear
+// interpolation in temperature.
+//
+// The tables cover 0.1 to 16.5 MPa (below IF97 region 3) and 273.15 to 1073.15 K; inputs
+// outside are clamped to the edge. Cells that straddle the saturation line blend liquid
+// and vapour values, which smears the jump in density and heat capacity over one
+// temperature step (about 3 K).
+//
+// Two-phase coolant is tracked by specific enthalpy, so there is also an inverse table of
+// temperature over [pressure][enthalpy] and a saturation table per pressure row. Between the
+// saturated liquid and vapour enthalpies the temperature reads exactly Tsat.
+//
+// Units are SI throughout: Pa, K, kg/m^3, J/(kg K), J/kg, Pa s, W/(m K).
+class WaterProperties {
+public:
+    enum class Property {
+        Density,
+        HeatCapacity, // Isobaric
+        Enthalpy,
+        Viscosity,
+        ThermalConductivity,
+        Count
+    };
+
+    static constexpr double minPressure = 0.1e6;
+    static constexpr double maxPressure = 16.5e6;
+    static constexpr double minTemperature = 273.15;
+    static constexpr double maxTemperature = 1073.15;
+    static constexpr double nominalPressure = 15.5e6; // Primary coolant system
+
+    // Shared tables, built on first use
+    static const WaterProperties& get();
+
+    [[nodiscard]] double lookup(Property property, double pressure, double temperature) const;
+    void lookup(Property property, double pressure, std::span<const double> temperatures, std::span<double> out) const;
+
+    // Temperature of water or steam holding a specific enthalpy (J/kg)
+    [[nodiscard]] double temperature(double pressure, double enthalpy) const;
+    void temperatures(double pressure, std::span<const double> enthalpies, std::span<double> out) const;
+
+    // Saturated liquid and vapour at a pressure
+    struct Saturation {
+        double temperature;
+        double liquidEnthalpy;
+        double vapourEnthalpy;
+        double liquidDensity;
+        double vapourDensity;
+        double surfaceTension; // N/m
+
+        // Saturated liquid transport properties, for heat transfer to boiling coolant
+        double liquidHeatCapacity;
+        double liquidViscosity;
+        double liquidConductivity;
+
+        // Vapour mass fraction of an enthalpy, 0 for subcooled liquid and 1 for steam
+        [[nodiscard]] double quality(double enthalpy) const {
+            return std::clamp((enthalpy - liquidEnthalpy) / (vapourEnthalpy - liquidEnthalpy), 0.0, 1.0);
+        }
+    };
+    [[nodiscard]] Saturation saturation(double pressure) const;
+
+    // Closed-form IF97, for building the tables and for checking them
+    struct State {
+        double density;
+        double heatCapacity;
+        double enthalpy;
+        double viscosity;
+        double thermalConductivity;
+    };
+    static State evaluate(double pressure, double temperature);
+    static double saturationPressure(double temperature);
+    static double saturationTemperature(double pressure);
+    static Saturation evaluateSaturation(double pressure);
+
+private:
+    static constexpr int pressureCount = 42;
+    static constexpr int temperatureCount = 256;
+    static constexpr double pressureStep = (maxPressure - minPressure) / (pressureCount - 1);
+    static constexpr double temperatureStep = (maxTemperature - minTemperature) / (temperatureCount - 1);
+    static constexpr int enthalpyCount = 512;
+    static constexpr double minEnthalpy = 0.0;
+    static constexpr double maxEnthalpy = 4.2e6;
+    static constexpr double enthalpyStep = (maxEnthalpy - minEnthalpy) / (enthalpyCount - 1);
+
+    std::vector<float> tables[static_cast<int>(Property::Count)];
+    std::vector<float> temperatureTable;   // [pressure][enthalpy]
+    std::vector<Saturation> saturationTable; // Per pressure row
+
+    WaterProperties();
+
+    [[nodiscard]] const float* table(Property property) const { return tables[static_cast<int>(property)].data(); }
+};
+
+#endif // WATERPROPERTIES_H
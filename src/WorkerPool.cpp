@@ -0,0 +1,123 @@
+// WorkerPool.cpp
+
+#include "WorkerPool.h"
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+WorkerPool::WorkerPool(std::size_t threadCount)
+    : stopping(false) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (std::size_t i = 1; i < threadCount; ++i) {
+        workers.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkerPool::parallelFor(std::size_t count, const std::function<void(std::size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+    if (workers.empty() || count == 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            body(i);
+        }
+        return;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->body = &body;
+    job->count = count;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(job);
+    }
+    wake.notify_all();
+
+#ifdef _OPENMP
+    // The caller works like a worker while the job runs
+    int ompThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    runJob(*job);
+    omp_set_num_threads(ompThreads);
+#else
+    runJob(*job);
+#endif
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&] { return job->done.load() == job->count; });
+
+    auto it = std::find(jobs.begin(), jobs.end(), job);
+    if (it != jobs.end()) {
+        jobs.erase(it);
+    }
+    if (job->error) {
+        std::rethrow_exception(job->error);
+    }
+}
+
+void WorkerPool::runJob(Job& job) {
+    std::size_t i;
+    while ((i = job.next.fetch_add(1)) < job.count) {
+        if (!job.failed.load()) {
+            try {
+                (*job.body)(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!job.error) {
+                    job.error = std::current_exception();
+                }
+                job.failed = true;
+            }
+        }
+
+        // Counted even when skipped or failed, so the owner always wakes
+        if (job.done.fetch_add(1) + 1 == job.count) {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished.notify_all();
+        }
+    }
+}
+
+void WorkerPool::workerLoop() {
+#ifdef _OPENMP
+    // Work is already spread over the pool; nested OpenMP teams would oversubscribe
+    omp_set_num_threads(1);
+#endif
+
+    while (true) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) {
+                return;
+            }
+
+            job = jobs.front();
+            if (job->next.load() >= job->count) {
+                // Every index has been claimed; the owner removes it once they finish
+                jobs.pop_front();
+                continue;
+            }
+        }
+
+        runJob(*job);
+    }
+}
@@ -0,0 +1,58 @@
+// WorkerPool.h
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads shared by everything that steps in parallel.
+//
+// parallelFor hands out indices one at a time from an atomic counter, and the calling
+// thread works on its own loop too, so a parallelFor issued from inside a worker cannot
+// deadlock: in the worst case the caller runs every index itself. If the body throws, the
+// remaining indices are skipped and parallelFor rethrows the first exception once every
+// thread has left the job.
+class WorkerPool {
+public:
+    // threadCount includes the calling thread; 0 means one per hardware thread
+    explicit WorkerPool(std::size_t threadCount = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& body);
+
+    [[nodiscard]] std::size_t getThreadCount() const { return workers.size() + 1; }
+
+private:
+    struct Job {
+        const std::function<void(std::size_t)>* body;
+        std::size_t count;
+        std::atomic<std::size_t> next{0};
+        std::atomic<std::size_t> done{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr error; // First exception thrown by the body, under the pool mutex
+    };
+
+    std::vector<std::thread> workers;
+    std::deque<std::shared_ptr<Job>> jobs;
+    bool stopping;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+
+    void workerLoop();
+    void runJob(Job& job);
+};
+
+#endif // WORKERPOOL_H
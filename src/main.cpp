@@ -1,21 +1,128 @@
 #include "MainSimulation.h"
 #include "Visualization.h"
 #include "Core.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
 #include <thread>
 
-int main() {
-    // Create core and coolant loop
+int main(int argc, char* argv[]) {
+    // Optional telemetry recording
+    std::string recordPath;
+    std::string recordSignals;
+    int recordDecimation = 30;
+
+    // Session journaling and replay
+    SimulationOptions options;
+    std::string replayPath;
+    bool headless = false;
+    int coolantLoops = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (arg == "--record-signals" && i + 1 < argc) {
+            recordSignals = argv[++i];
+        } else if (arg == "--record-decimation" && i + 1 < argc) {
+            recordDecimation = std::stoi(argv[++i]);
+        } else if (arg == "--journal" && i + 1 < argc) {
+            options.journalPath = argv[++i];
+        } else if (arg == "--fixed-step" && i + 1 < argc) {
+            options.fixedTimeStep = std::stod(argv[++i]);
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (arg == "--scenario" && i + 1 < argc) {
+            options.scenarioPath = argv[++i];
+        } else if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--point-kinetics") {
+            options.pointKinetics = true;
+        } else if (arg == "--coolant-loops" && i + 1 < argc) {
+            coolantLoops = std::max(1, std::stoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--record file] [--record-signals name,name,...] [--record-decimation steps]"
+                      << " [--journal file] [--fixed-step seconds] [--replay file]"
+                      << " [--scenario file] [--headless] [--point-kinetics] [--coolant-loops count]" << std::endl;
+            return 1;
+        }
+    }
+
+    RecorderConfig recorderConfig = RecorderConfig::allSignals(recordPath);
+    recorderConfig.fieldDecimation = recordDecimation;
+    if (!recordSignals.empty() && !TelemetryRecorder::parseSignals(recordSignals, recorderConfig)) {
+        return 1;
+    }
+
+    if (!replayPath.empty()) {
+        // Headless, unthrottled re-run of a journaled session
+        CommandJournal journal;
+        if (!journal.load(replayPath)) {
+            return 1;
+        }
+
+        Core core(journal.xSize, journal.ySize, journal.zSize);
+        CoolantSystem coolantSystem(journal.coolantLoops, journal.coolantChunks);
+        WorkerPool coolantPool(static_cast<std::size_t>(journal.coolantLoops));
+        std::atomic<bool> running(true);
+
+        // The journal's model options, whatever the command line asked for
+        options.pointKinetics = journal.model.pointKinetics;
+        options.fluxSubsteps = journal.model.fluxSubsteps;
+        options.burnupInterval = journal.model.burnupInterval;
+        options.conductionInterval = journal.model.conductionInterval;
+        options.adaptiveStep = journal.model.adaptiveStep;
+        options.stepTolerance = journal.model.stepTolerance;
+        options.interactive = false;
+        options.journalPath.clear();
+        options.scenarioPath.clear();
+        options.workerPool = &coolantPool;
+        MainSimulation simulation(core, coolantSystem, running, options);
+        if (!recordPath.empty() && !simulation.enableRecording(recorderConfig)) {
+            std::cerr << "Continuing without telemetry recording." << std::endl;
+        }
+        return simulation.replay(journal) ? 0 : 1;
+    }
+
+    // Create core and coolant loops; the loops step in parallel, one thread each
     Core core(10, 10, 10);
-    CoolantLoop coolantLoop(100);
+    CoolantSystem coolantSystem(coolantLoops, 100);
+    WorkerPool coolantPool(static_cast<std::size_t>(coolantLoops));
+    options.workerPool = &coolantPool;
 
     // Atomic flag to control running state
     std::atomic<bool> running(true);
 
+    if (headless) {
+        // Unattended batch run: no window, no operator input, no throttling
+        options.interactive = false;
+        options.realTime = false;
+        MainSimulation simulation(core, coolantSystem, running, options);
+        if (!recordPath.empty() && !simulation.enableRecording(recorderConfig)) {
+            std::cerr << "Continuing without telemetry recording." << std::endl;
+        }
+
+        simulation.runSimulation();
+
+        PlantTelemetry telemetry = simulation.getTelemetry();
+        std::cout << "Finished at t = " << telemetry.simTime << " s after " << telemetry.step << " steps"
+                  << ", max core temperature " << telemetry.maxCoreTemperature << " K"
+                  << (telemetry.scramInitiated ? ", scrammed" : "") << std::endl;
+        return 0;
+    }
+
     // Create the visualization object
-    Visualization visualization(core, coolantLoop, running);
+    Visualization visualization(core, coolantSystem, running);
 
     // Start the simulation in a separate thread
-    MainSimulation simulation(core, coolantLoop, running);
+    MainSimulation simulation(core, coolantSystem, running, options);
+
+    if (!recordPath.empty() && !simulation.enableRecording(recorderConfig)) {
+        std::cerr << "Continuing without telemetry recording." << std::endl;
+    }
+
     std::thread simulationThread(&MainSimulation::runSimulation, &simulation);
 
     // Start the visualization on the main thread
@@ -25,4 +132,4 @@ int main() {
     simulationThread.join();
 
     return 0;
-}
\ No newline at end of file
+}